@@ -1,36 +1,149 @@
 #include "algorithm.hpp"
 
-#include "shaders/all_shaders.hpp"
+#include <algorithm>
+
+#include "tracer.hpp"
 
 namespace vulkan {
-Algorithm::Algorithm(VulkanMemoryResource* mr_ptr, std::string shader_name)
-    : device_ref_(mr_ptr->get_device()), mr_ptr_(mr_ptr), shader_name_(std::move(shader_name)) {
-  load_compiled_shader();
-  create_shader_module();
+
+namespace {
+
+// maxPushDescriptors is at least 32 on every device exposing the extension
+constexpr size_t kMaxPushDescriptors = 32;
+
+}  // namespace
+
+Algorithm::Algorithm(VulkanMemoryResource* mr_ptr,
+                     PipelineRegistry* registry_ptr,
+                     std::string shader_name,
+                     const uint32_t subgroup_size)
+    : device_ref_(mr_ptr->get_device()),
+      mr_ptr_(mr_ptr),
+      registry_ptr_(registry_ptr),
+      shader_name_(std::move(shader_name)) {
+  if (shader_name_.empty()) {
+    throw std::runtime_error("Shader name is empty");
+  }
+
+  shader_module_ = registry_ptr_->get_shader_module(shader_name_);
+  reflection_ = &registry_ptr_->get_reflection(shader_name_);
+
+  for (const auto& binding : reflection_->bindings) {
+    if (binding.set != 0 || binding.type != vk::DescriptorType::eStorageBuffer ||
+        binding.count != 1) {
+      throw std::runtime_error("Shader " + shader_name_ +
+                               " uses a binding other than a single storage buffer in set 0");
+    }
+  }
+
+  // Defaults come from the shader itself, the builder methods only override them
+  internal_.num_buffers = reflected_num_buffers();
+  internal_.push_constant_size = reflection_->push_constant_size;
+  std::ranges::copy(reflection_->local_size, internal_.work_group_size);
+
+  // Shaders that declare the subgroup size constant get the device's width, and the
+  // pipeline is pinned to it so 'gl_SubgroupSize' matches what the shader assumes
+  if (subgroup_size > 0 && has_spec_constant(kSubgroupSizeConstantId)) {
+    internal_.specialization[kSubgroupSizeConstantId] = subgroup_size;
+    internal_.required_subgroup_size = subgroup_size;
+  }
 }
 
 std::shared_ptr<Algorithm> Algorithm::work_group_size(const uint32_t x,
                                                       const uint32_t y,
                                                       const uint32_t z) {
+  const std::array<uint32_t, 3> requested = {x, y, z};
+
+  for (size_t i = 0; i < 3; ++i) {
+    if (const auto spec_id = reflection_->local_size_spec_ids[i]) {
+      // 'local_size_*_id' dimension, feed it to the pipeline
+      internal_.specialization[*spec_id] = requested[i];
+    } else if (requested[i] != reflection_->local_size[i]) {
+      throw std::runtime_error("Work group size does not match the local size of shader " +
+                               shader_name_);
+    }
+  }
+
   internal_.work_group_size[0] = x;
   internal_.work_group_size[1] = y;
   internal_.work_group_size[2] = z;
   return shared_from_this();
 }
 
+std::shared_ptr<Algorithm> Algorithm::specialization_constant_bits(const uint32_t constant_id,
+                                                                   const uint32_t bits) {
+  if (!has_spec_constant(constant_id)) {
+    throw std::runtime_error("Shader " + shader_name_ + " has no specialization constant " +
+                             std::to_string(constant_id));
+  }
+
+  // Keep 'work_group_size' in sync when a local size dimension is set directly
+  for (size_t i = 0; i < 3; ++i) {
+    if (reflection_->local_size_spec_ids[i] == constant_id) {
+      internal_.work_group_size[i] = bits;
+    }
+  }
+
+  // Overriding the subgroup width also changes the width the pipeline is pinned to
+  if (constant_id == kSubgroupSizeConstantId) {
+    internal_.required_subgroup_size = bits;
+  }
+
+  internal_.specialization[constant_id] = bits;
+  return shared_from_this();
+}
+
+bool Algorithm::has_spec_constant(const uint32_t constant_id) const {
+  return std::ranges::any_of(reflection_->spec_constants,
+                             [constant_id](const auto& c) { return c.id == constant_id; });
+}
+
 std::shared_ptr<Algorithm> Algorithm::num_buffers(const size_t n) {
+  if (descriptor_set_layout_) {
+    throw std::runtime_error("Number of buffers already set");
+  }
+
+  // Bindings the optimizer stripped from the shader are fine to over-declare
+  if (n < reflected_num_buffers()) {
+    throw std::runtime_error("Shader " + shader_name_ + " uses " +
+                             std::to_string(reflected_num_buffers()) + " buffers, got " +
+                             std::to_string(n));
+  }
+
   internal_.num_buffers = n;
-  create_descriptor_set_layout();
-  create_descriptor_pool();
-  allocate_descriptor_sets();
   return shared_from_this();
 }
 
 std::shared_ptr<Algorithm> Algorithm::push_constant_size(const size_t size_in_bytes) {
+  if (size_in_bytes < reflection_->push_constant_size) {
+    throw std::runtime_error("Shader " + shader_name_ + " expects " +
+                             std::to_string(reflection_->push_constant_size) +
+                             " bytes of push constants, got " + std::to_string(size_in_bytes));
+  }
+
   internal_.push_constant_size = size_in_bytes;
   return shared_from_this();
 }
 
+size_t Algorithm::reflected_num_buffers() const {
+  return reflection_->bindings.empty() ? 0 : reflection_->bindings.back().binding + 1;
+}
+
+std::vector<uint32_t> Algorithm::flattened_specialization() const {
+  std::vector<uint32_t> data;
+  data.reserve(internal_.specialization.size() * 2);
+  for (const auto& [id, bits] : internal_.specialization) {
+    data.push_back(id);
+    data.push_back(bits);
+  }
+  return data;
+}
+
+BufferAccess Algorithm::get_buffer_access(const uint32_t binding) const {
+  const auto it = std::ranges::find(reflection_->bindings, binding, &ReflectedBinding::binding);
+  return it == reflection_->bindings.end() ? BufferAccess::kReadWrite : it->access;
+}
+
 void Algorithm::update_push_constant(const void* data_ptr, const size_t size_in_bytes) {
   if (!has_push_constants()) {
     throw std::runtime_error("Algorithm has no push constants allocated");
@@ -44,40 +157,37 @@ void Algorithm::update_push_constant(const void* data_ptr, const size_t size_in_
 }
 
 void Algorithm::update_buffer(const std::initializer_list<vk::DescriptorBufferInfo> buffer_infos) {
+  update_buffer(std::span(buffer_infos.begin(), buffer_infos.size()));
+}
+
+void Algorithm::update_buffer(const std::span<const vk::DescriptorBufferInfo> buffer_infos) {
   spdlog::trace("Algorithm::update_buffer()");
+  const ScopedTrace trace("Algorithm::update_buffer");
 
-  if (buffer_infos.size() != internal_.num_buffers) {
+  // Bindless kernels take any number of buffers, they are only tracked for barriers
+  if (!is_bindless() && buffer_infos.size() != internal_.num_buffers) {
     throw std::runtime_error("Buffer info size mismatch");
   }
 
-  // need to have descriptor set before updating buffer
-  if (descriptor_set_ == nullptr) {
-    throw std::runtime_error("Descriptor set is not initialized");
+  if (pipeline_ == nullptr) {
+    throw std::runtime_error("Algorithm is not built, call build() first");
   }
 
-  buffer_infos_ = buffer_infos;
+  // Descriptors are written when a dispatch is recorded
+  buffer_infos_.assign(buffer_infos.begin(), buffer_infos.end());
+}
 
-  std::vector<vk::WriteDescriptorSet> compute_write_descriptor_sets;
-  compute_write_descriptor_sets.reserve(buffer_infos.size());
+std::shared_ptr<Algorithm> Algorithm::build() {
+  const ScopedTrace trace("Algorithm::build");
 
-  for (uint32_t i = 0; i < buffer_infos.size(); ++i) {
-    compute_write_descriptor_sets.emplace_back(vk::WriteDescriptorSet{
-        .dstSet = descriptor_set_,
-        .dstBinding = i,
-        .dstArrayElement = 0,
-        .descriptorCount = 1,
-        .descriptorType = vk::DescriptorType::eStorageBuffer,
-        .pBufferInfo = (buffer_infos.begin() + i),
-    });
-  }
+  if (internal_.num_buffers > 0 && !descriptor_set_layout_) {
+    descriptor_set_layout_ = registry_ptr_->get_descriptor_set_layout(internal_.num_buffers);
 
-  device_ref_.updateDescriptorSets(static_cast<uint32_t>(compute_write_descriptor_sets.size()),
-                                   compute_write_descriptor_sets.data(),
-                                   0,
-                                   nullptr);
-}
+    if (!registry_ptr_->uses_push_descriptors()) {
+      update_template_ = registry_ptr_->get_update_template(internal_.num_buffers);
+    }
+  }
 
-std::shared_ptr<Algorithm> Algorithm::build() {
   create_pipeline();
   return shared_from_this();
 }
@@ -86,12 +196,52 @@ std::shared_ptr<Algorithm> Algorithm::build() {
 // record_bind_core / record_bind_push
 // ----------------------------------------------------------------------------
 
-void Algorithm::record_bind_core(const vk::CommandBuffer& cmd_buf) const {
+void Algorithm::record_bind_core(const vk::CommandBuffer& cmd_buf,
+                                 DescriptorRing& descriptor_ring) const {
   spdlog::trace("Algorithm::record_bind_core()");
 
+  if (is_bindless()) {
+    cmd_buf.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_);
+    return;
+  }
+
+  if (buffer_infos_.size() != internal_.num_buffers) {
+    throw std::runtime_error("Buffers of " + shader_name_ + " are not bound");
+  }
+
   cmd_buf.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline_);
-  cmd_buf.bindDescriptorSets(
-      vk::PipelineBindPoint::eCompute, pipeline_layout_, 0, descriptor_set_, nullptr);
+
+  // A fresh set per dispatch, so pending command buffers keep what they were recorded with
+  if (update_template_) {
+    const auto descriptor_set = descriptor_ring.allocate(descriptor_set_layout_);
+    device_ref_.updateDescriptorSetWithTemplate(
+        descriptor_set, update_template_, buffer_infos_.data());
+    cmd_buf.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute, pipeline_layout_, 0, descriptor_set, nullptr);
+    return;
+  }
+
+  // The command buffer keeps its own copy of the bindings
+  std::array<vk::WriteDescriptorSet, kMaxPushDescriptors> writes;
+  if (buffer_infos_.size() > writes.size()) {
+    throw std::runtime_error("Too many buffers for push descriptors");
+  }
+
+  for (uint32_t i = 0; i < buffer_infos_.size(); ++i) {
+    writes[i] = vk::WriteDescriptorSet{
+        .dstBinding = i,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .pBufferInfo = &buffer_infos_[i],
+    };
+  }
+
+  cmd_buf.pushDescriptorSetKHR(vk::PipelineBindPoint::eCompute,
+                               pipeline_layout_,
+                               0,
+                               vk::ArrayProxy<const vk::WriteDescriptorSet>(
+                                   static_cast<uint32_t>(buffer_infos_.size()), writes.data()));
 }
 
 void Algorithm::record_bind_push(const vk::CommandBuffer& cmd_buf) const {
@@ -125,107 +275,6 @@ void Algorithm::record_dispatch(const vk::CommandBuffer& cmd_buf,
   cmd_buf.dispatch(grid_size[0], grid_size[1], grid_size[2]);
 }
 
-// -------------------------------------------------------------------------------------------------
-// Shader Related
-//   load_compiled_shader();
-//   create_shader_module();
-// -------------------------------------------------------------------------------------------------
-
-void Algorithm::load_compiled_shader() {
-  if (!shaders::all_shaders.contains(shader_name_)) {
-    throw std::runtime_error("Shader " + shader_name_ + " not found");
-  }
-
-  const auto [shader_binary, shader_binary_size] = shaders::all_shaders.at(shader_name_);
-
-  internal_.spirv_binary.resize(shader_binary_size / sizeof(uint32_t));
-  std::memcpy(internal_.spirv_binary.data(), shader_binary, shader_binary_size);
-}
-
-void Algorithm::create_shader_module() {
-  if (shader_name_.empty()) {
-    throw std::runtime_error("Shader name is empty");
-  }
-
-  if (internal_.spirv_binary.empty()) {
-    throw std::runtime_error("SPIRV binary is empty");
-  }
-
-  const vk::ShaderModuleCreateInfo create_info{
-      .codeSize = internal_.spirv_binary.size() * sizeof(uint32_t),
-      .pCode = internal_.spirv_binary.data(),
-  };
-
-  shader_module_ = device_ref_.createShaderModule(create_info);
-
-  spdlog::debug("Shader module [{}] created successfully", shader_name_);
-}
-
-// ----------------------------------------------------------------------------
-// Descriptor Related
-//   create_descriptor_set_layout();
-//   create_descriptor_pool();
-//   allocate_descriptor_sets();
-// ----------------------------------------------------------------------------
-
-void Algorithm::create_descriptor_set_layout() {
-  spdlog::trace("Algorithm::create_descriptor_set_layout() num_buffers: {}", internal_.num_buffers);
-
-  if (internal_.num_buffers == 0) {
-    throw std::runtime_error("Number of buffers is 0");
-  }
-
-  std::vector<vk::DescriptorSetLayoutBinding> bindings;
-  bindings.reserve(internal_.num_buffers);
-
-  for (uint32_t i = 0; i < internal_.num_buffers; ++i) {
-    bindings.emplace_back(vk::DescriptorSetLayoutBinding{
-        .binding = i,
-        .descriptorType = vk::DescriptorType::eStorageBuffer,
-        .descriptorCount = 1,
-        .stageFlags = vk::ShaderStageFlagBits::eCompute,
-    });
-  }
-
-  const vk::DescriptorSetLayoutCreateInfo create_info{
-      .bindingCount = static_cast<uint32_t>(bindings.size()),
-      .pBindings = bindings.data(),
-  };
-
-  descriptor_set_layout_ = device_ref_.createDescriptorSetLayout(create_info);
-}
-
-void Algorithm::create_descriptor_pool() {
-  const std::vector pool_sizes{
-      vk::DescriptorPoolSize{
-          .type = vk::DescriptorType::eStorageBuffer,
-          .descriptorCount = static_cast<uint32_t>(internal_.num_buffers),
-      },
-  };
-
-  const vk::DescriptorPoolCreateInfo create_info{
-      .maxSets = 1,
-      .poolSizeCount = static_cast<uint32_t>(pool_sizes.size()),
-      .pPoolSizes = pool_sizes.data(),
-  };
-
-  descriptor_pool_ = device_ref_.createDescriptorPool(create_info);
-}
-
-void Algorithm::allocate_descriptor_sets() {
-  if (descriptor_pool_ == nullptr || descriptor_set_layout_ == nullptr) {
-    throw std::runtime_error("Descriptor pool or set layout is not initialized");
-  }
-
-  const vk::DescriptorSetAllocateInfo allocate_info{
-      .descriptorPool = descriptor_pool_,
-      .descriptorSetCount = 1,
-      .pSetLayouts = &descriptor_set_layout_,
-  };
-
-  descriptor_set_ = device_ref_.allocateDescriptorSets(allocate_info).front();
-}
-
 // ----------------------------------------------------------------------------
 // Pipeline Related
 //   create_pipeline();
@@ -234,59 +283,32 @@ void Algorithm::allocate_descriptor_sets() {
 void Algorithm::create_pipeline() {
   spdlog::trace("Algorithm::create_pipeline()");
 
-  if (descriptor_set_layout_ == nullptr) {
+  if (!is_bindless() && descriptor_set_layout_ == nullptr) {
     throw std::runtime_error("Descriptor set layout is not initialized");
   }
 
-  if (internal_.num_buffers == 0) {
-    throw std::runtime_error("Number of buffers is 0");
-  }
-
-  if (internal_.work_group_size[0] == 0 || internal_.work_group_size[1] == 0 ||
-      internal_.work_group_size[2] == 0) {
-    throw std::runtime_error("Work group size is not set");
-  }
-
   assert(internal_.push_constant_size <= push_constants_buffer_.size());
 
-  // Push Constants
-  std::vector<vk::PushConstantRange> push_constant_ranges;
+  // Layouts and pipeline are shared with every Algorithm built with the same key
+  pipeline_layout_ =
+      registry_ptr_->get_pipeline_layout(internal_.num_buffers, internal_.push_constant_size);
 
-  if (has_push_constants()) {
-    push_constant_ranges.emplace_back(vk::PushConstantRange{
-        .stageFlags = vk::ShaderStageFlagBits::eCompute,
-        .offset = 0,
-        .size = static_cast<uint32_t>(internal_.push_constant_size),
-    });
-  }
+  pipeline_ = registry_ptr_->get_pipeline(get_pipeline_key());
 
-  // Pipeline Layout
-  const vk::PipelineLayoutCreateInfo pipeline_layout_create_info{
-      .setLayoutCount = 1,
-      .pSetLayouts = &descriptor_set_layout_,
-      .pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size()),
-      .pPushConstantRanges = push_constant_ranges.empty() ? nullptr : push_constant_ranges.data()};
-
-  pipeline_layout_ = device_ref_.createPipelineLayout(pipeline_layout_create_info);
-
-  pipeline_cache_ = device_ref_.createPipelineCache(vk::PipelineCacheCreateInfo{});
-
-  // Pipeline
-  const vk::PipelineShaderStageCreateInfo shader_stage_create_info{
-      .stage = vk::ShaderStageFlagBits::eCompute,
-      .module = shader_module_,
-      .pName = "main",
-  };
+  spdlog::debug("Pipeline [{}] ready", shader_name_);
+}
 
-  const vk::ComputePipelineCreateInfo pipeline_create_info{
-      .stage = shader_stage_create_info,
-      .layout = pipeline_layout_,
-      .basePipelineHandle = nullptr,
+PipelineKey Algorithm::get_pipeline_key() const {
+  return PipelineKey{
+      .shader_name = shader_name_,
+      .num_buffers = internal_.num_buffers,
+      .push_constant_size = internal_.push_constant_size,
+      .work_group_size = {internal_.work_group_size[0],
+                          internal_.work_group_size[1],
+                          internal_.work_group_size[2]},
+      .specialization_data = flattened_specialization(),
+      .required_subgroup_size = internal_.required_subgroup_size,
   };
-
-  pipeline_ = device_ref_.createComputePipeline(pipeline_cache_, pipeline_create_info).value;
-
-  spdlog::debug("Pipeline [{}] created successfully", shader_name_);
 }
 
 }  // namespace vulkan
\ No newline at end of file
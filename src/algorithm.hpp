@@ -1,5 +1,12 @@
 #pragma once
 
+#include <bit>
+#include <map>
+#include <span>
+#include <type_traits>
+
+#include "descriptor_ring.hpp"
+#include "pipeline_registry.hpp"
 #include "vk.hpp"
 #include "vma_pmr.hpp"
 
@@ -18,13 +25,49 @@ namespace vulkan {
  */
 constexpr auto div_ceil(size_t a, size_t b) { return (a + b - 1) / b; }
 
+// Work groups per grid dimension every device supports (maxComputeWorkGroupCount). Kernels
+// that may need more are dispatched with at most this many and loop over the rest.
+constexpr uint32_t kMaxWorkGroupCount = 65535;
+
+// Shaders declare 'layout(constant_id = 0) const uint SUBGROUP_SIZE' (or WARP_SIZE) to
+// have the engine specialize them for the device's subgroup width
+constexpr uint32_t kSubgroupSizeConstantId = 0;
+
+/**
+ * @brief A lightweight handle to a compute pipeline plus its own descriptor state
+ *
+ * Shader module, set layout, pipeline layout and pipeline are interned in the
+ * engine's 'PipelineRegistry', so creating many Algorithms for the same
+ * shader/configuration is cheap. Each Algorithm only owns its buffer bindings
+ * and the push constant payload.
+ *
+ * Bindings are written when a dispatch is recorded, so 'update_buffer()' is a
+ * plain copy and an Algorithm can be rebound between dispatches of the same
+ * recording, or while an earlier submission is in flight. With
+ * VK_KHR_push_descriptor they are pushed into the command buffer; without it
+ * each dispatch gets its own set from the Sequence's 'DescriptorRing',
+ * written through an update template.
+ *
+ * A shader without descriptor bindings is bindless: it reads its buffers
+ * through 'GL_EXT_buffer_reference' pointers passed in the push constants
+ * (see 'Engine::get_device_address()'), and no descriptors are used at all.
+ */
 class Algorithm final : public std::enable_shared_from_this<Algorithm> {
  public:
-  explicit Algorithm(VulkanMemoryResource* mr_ptr, std::string shader_name);
+  explicit Algorithm(VulkanMemoryResource* mr_ptr,
+                     PipelineRegistry* registry_ptr,
+                     std::string shader_name,
+                     uint32_t subgroup_size = 0);
 
-  ~Algorithm() = default;
+  Algorithm(const Algorithm&) = delete;
+  Algorithm& operator=(const Algorithm&) = delete;
 
   // Builder pattern
+  //
+  // Buffer count, push constant size and work group size are reflected from
+  // the SPIR-V, so these are optional. When given, they are checked against
+  // the shader and a mismatch throws. Dimensions declared with
+  // 'local_size_*_id' are specialized to the requested size instead.
   [[nodiscard]] std::shared_ptr<Algorithm> work_group_size(uint32_t x, uint32_t y, uint32_t z);
   [[nodiscard]] std::shared_ptr<Algorithm> num_buffers(size_t n);
   [[nodiscard]] std::shared_ptr<Algorithm> push_constant_size(size_t size_in_bytes);
@@ -32,6 +75,32 @@ class Algorithm final : public std::enable_shared_from_this<Algorithm> {
   [[nodiscard]] std::shared_ptr<Algorithm> push_constant() {
     return push_constant_size(sizeof(T));
   }
+
+  /**
+   * @brief Set a 'layout(constant_id = N)' specialization constant
+   * @tparam T uint32_t, int32_t, float or bool
+   * @param constant_id The constant_id declared in the shader
+   * @param value Value baked into the pipeline at build()
+   *
+   * Example usage:
+   * ```cpp
+   * // shader: layout(constant_id = 2) const float SCALE = 1.0;
+   * auto algo = engine.make_algo("my_kernel")
+   *                 ->specialization_constant(2, 0.5f)
+   *                 ->build();
+   * ```
+   */
+  template <typename T>
+  [[nodiscard]] std::shared_ptr<Algorithm> specialization_constant(uint32_t constant_id, T value) {
+    static_assert(sizeof(T) == sizeof(uint32_t) || std::is_same_v<T, bool>,
+                  "Specialization constants must be 32-bit scalars or bool");
+    if constexpr (std::is_same_v<T, bool>) {
+      return specialization_constant_bits(constant_id, value ? 1u : 0u);  // VkBool32
+    } else {
+      return specialization_constant_bits(constant_id, std::bit_cast<uint32_t>(value));
+    }
+  }
+
   [[nodiscard]] std::shared_ptr<Algorithm> build();
 
   // Pass actual data
@@ -60,6 +129,13 @@ class Algorithm final : public std::enable_shared_from_this<Algorithm> {
    * @brief Update buffer bindings for the compute shader
    * @param buffer_infos List of buffer descriptors to bind
    *
+   * Takes effect for dispatches recorded after the call, dispatches recorded
+   * before keep the buffers they were recorded with.
+   *
+   * For a bindless Algorithm these are the buffers its pointers reach, in any
+   * number. They are not bound, only used for barriers and coherency; without
+   * them 'Sequence' conservatively places barriers around the dispatch.
+   *
    * Example usage:
    * ```cpp
    * algo->update_buffer({
@@ -70,9 +146,10 @@ class Algorithm final : public std::enable_shared_from_this<Algorithm> {
    * ```
    */
   void update_buffer(std::initializer_list<vk::DescriptorBufferInfo> buffer_infos);
+  void update_buffer(std::span<const vk::DescriptorBufferInfo> buffer_infos);
 
   // Used by 'Sequence' Class
-  void record_bind_core(const vk::CommandBuffer& cmd_buf) const;
+  void record_bind_core(const vk::CommandBuffer& cmd_buf, DescriptorRing& descriptor_ring) const;
   void record_bind_push(const vk::CommandBuffer& cmd_buf) const;
 
   // basically CUDA's <<< grid_size >>>
@@ -80,28 +157,51 @@ class Algorithm final : public std::enable_shared_from_this<Algorithm> {
 
   [[nodiscard]] bool has_push_constants() const { return internal_.push_constant_size > 0; }
 
+  // No descriptor bindings, buffers are passed as device addresses
+  [[nodiscard]] bool is_bindless() const { return internal_.num_buffers == 0; }
+
+  [[nodiscard]] size_t get_num_buffers() const { return internal_.num_buffers; }
+
+  // Registry key of the built pipeline, for variants of it (see 'Graph')
+  [[nodiscard]] PipelineKey get_pipeline_key() const;
+
+  [[nodiscard]] const std::string& get_shader_name() const { return shader_name_; }
+  [[nodiscard]] const ShaderReflection& get_reflection() const { return *reflection_; }
+
+  // 'readonly'/'writeonly' qualifier of a binding, as declared in the shader
+  [[nodiscard]] BufferAccess get_buffer_access(uint32_t binding) const;
+
+  // Payload of the last 'update_push_constant()'
+  [[nodiscard]] std::span<const std::byte> get_push_constants() const {
+    return {push_constants_buffer_.data(), internal_.push_constant_size};
+  }
+
+  // Buffers bound by the last 'update_buffer()', indexed by binding
+  [[nodiscard]] const std::vector<vk::DescriptorBufferInfo>& get_buffer_infos() const {
+    return buffer_infos_;
+  }
+
  private:
-  void load_compiled_shader();
+  [[nodiscard]] size_t reflected_num_buffers() const;
+  [[nodiscard]] bool has_spec_constant(uint32_t constant_id) const;
+  [[nodiscard]] std::vector<uint32_t> flattened_specialization() const;
 
-  void create_shader_module();
-  void create_descriptor_set_layout();
-  void create_descriptor_pool();
-  void allocate_descriptor_sets();
+  std::shared_ptr<Algorithm> specialization_constant_bits(uint32_t constant_id, uint32_t bits);
 
   void create_pipeline();
 
   // References
   vk::Device device_ref_;
   VulkanMemoryResource* mr_ptr_;
+  PipelineRegistry* registry_ptr_;
+  const ShaderReflection* reflection_ = nullptr;
 
-  // Core vulkan handles
+  // Shared vulkan handles (owned by the registry)
   vk::ShaderModule shader_module_ = nullptr;
   vk::Pipeline pipeline_ = nullptr;
-  vk::PipelineCache pipeline_cache_ = nullptr;
   vk::PipelineLayout pipeline_layout_ = nullptr;
   vk::DescriptorSetLayout descriptor_set_layout_ = nullptr;
-  vk::DescriptorPool descriptor_pool_ = nullptr;
-  vk::DescriptorSet descriptor_set_ = nullptr;
+  vk::DescriptorUpdateTemplate update_template_ = nullptr;  // null with push descriptors
 
   std::string shader_name_;
 
@@ -110,10 +210,11 @@ class Algorithm final : public std::enable_shared_from_this<Algorithm> {
   std::vector<vk::DescriptorBufferInfo> buffer_infos_;
 
   struct {
-    std::vector<uint32_t> spirv_binary;
     size_t num_buffers = 0;
     size_t push_constant_size = 0;
     uint32_t work_group_size[3] = {0, 0, 0};
+    std::map<uint32_t, uint32_t> specialization;  // constant_id -> value bits
+    uint32_t required_subgroup_size = 0;
   } internal_;
 };
 
@@ -2,6 +2,7 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <limits>
 
 #define VMA_STATIC_VULKAN_FUNCTIONS 0
@@ -32,8 +33,12 @@ BaseEngine::BaseEngine(const bool enable_validation_layer)
 
   create_instance();
   create_physical_device();
+  limits_ = physical_device_.getProperties().limits;
+  detect_unified_memory();
   create_device();
 
+  query_subgroup_properties();
+
   initialize_vma_allocator();
 }
 
@@ -186,6 +191,25 @@ void BaseEngine::create_physical_device(vk::PhysicalDeviceType type) {
   return vulkan12_features;
 }
 
+[[nodiscard]] static vk::PhysicalDeviceVulkan13Features check_vulkan_13_features(
+    const vk::PhysicalDevice &physical_device) {
+  // We only rely on 'subgroupSizeControl' and 'computeFullSubgroups' to pin the
+  // subgroup size of pipelines specialized for it. Enable those two when
+  // supported and leave every other 1.3 feature off.
+  vk::PhysicalDeviceVulkan13Features supported{};
+
+  vk::PhysicalDeviceFeatures2 features2{
+      .pNext = &supported,
+  };
+
+  physical_device.getFeatures2(&features2);
+
+  return vk::PhysicalDeviceVulkan13Features{
+      .subgroupSizeControl = supported.subgroupSizeControl,
+      .computeFullSubgroups = supported.computeFullSubgroups,
+  };
+}
+
 void BaseEngine::create_device(vk::QueueFlags queue_flags) {
   if (!physical_device_) {
     throw std::runtime_error("Physical device is not valid");
@@ -203,26 +227,195 @@ void BaseEngine::create_device(vk::QueueFlags queue_flags) {
     throw std::runtime_error("No queue family supports compute operations.");
   }
 
-  // Create a logical device with a compute queue
-  constexpr float queuePriority = 1.0f;
-  const vk::DeviceQueueCreateInfo deviceQueueCreateInfo{
-      .queueFamilyIndex = compute_queue_family_index_,
-      .queueCount = 1,
-      .pQueuePriorities = &queuePriority,
-  };
+  // Create every queue of every compute family (async compute on most discrete GPUs), the
+  // first family found above goes first so that queue 0 stays the default one
+  std::vector<uint32_t> compute_families = {compute_queue_family_index_};
+  std::optional<uint32_t> transfer_family;
+
+  for (uint32_t i = 0; i < queueFamilyProperties.size(); ++i) {
+    const auto flags = queueFamilyProperties[i].queueFlags;
+
+    if (i != compute_queue_family_index_ && (flags & queue_flags)) {
+      compute_families.push_back(i);
+    } else if (!transfer_family && (flags & vk::QueueFlagBits::eTransfer) &&
+               !(flags & (vk::QueueFlagBits::eCompute | vk::QueueFlagBits::eGraphics))) {
+      transfer_family = i;
+    }
+  }
 
-  const auto vulkan_12_features = check_vulkan_12_features(physical_device_);
+  const auto &largest_family = std::ranges::max(
+      queueFamilyProperties, {}, [](const auto &qfp) { return qfp.queueCount; });
+  const std::vector<float> queuePriorities(largest_family.queueCount, 1.0f);
+
+  std::vector<vk::DeviceQueueCreateInfo> deviceQueueCreateInfos;
+
+  for (const auto family : compute_families) {
+    deviceQueueCreateInfos.emplace_back(vk::DeviceQueueCreateInfo{
+        .queueFamilyIndex = family,
+        .queueCount = queueFamilyProperties[family].queueCount,
+        .pQueuePriorities = queuePriorities.data(),
+    });
+  }
+
+  if (transfer_family) {
+    deviceQueueCreateInfos.emplace_back(vk::DeviceQueueCreateInfo{
+        .queueFamilyIndex = *transfer_family,
+        .queueCount = 1,
+        .pQueuePriorities = queuePriorities.data(),
+    });
+  }
+
+  auto vulkan_12_features = check_vulkan_12_features(physical_device_);
+  auto vulkan_13_features = check_vulkan_13_features(physical_device_);
+  vulkan_12_features.pNext = &vulkan_13_features;
+
+  // Sequence submissions are tracked with timeline semaphores
+  if (!vulkan_12_features.timelineSemaphore) {
+    throw std::runtime_error("Timeline semaphores are not supported");
+  }
+
+  subgroup_size_control_ =
+      vulkan_13_features.subgroupSizeControl && vulkan_13_features.computeFullSubgroups;
+  update_after_bind_ = vulkan_12_features.descriptorBindingStorageBufferUpdateAfterBind;
+
+  // Optional extensions, each one unlocks a faster or more observable path
+  const auto available_extensions = physical_device_.enumerateDeviceExtensionProperties();
+  for (const char *name : {VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+                           VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME,
+                           VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
+                           VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME}) {
+    if (std::ranges::any_of(available_extensions, [name](const auto &ext) {
+          return std::string_view(ext.extensionName.data()) == name;
+        })) {
+      enabled_extensions_.push_back(name);
+      spdlog::debug("Enabling device extension {}", name);
+    }
+  }
+
+  // 'Tracer' runs on steady_clock, which is CLOCK_MONOTONIC on Linux and Android
+  if (is_extension_enabled(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)) {
+    const auto time_domains = physical_device_.getCalibrateableTimeDomainsEXT();
+    calibrated_timestamps_ =
+        std::ranges::find(time_domains, vk::TimeDomainEXT::eDevice) != time_domains.end() &&
+        std::ranges::find(time_domains, vk::TimeDomainEXT::eClockMonotonic) != time_domains.end();
+  }
+
+  // 64-bit integers for buffer device addresses in bindless kernels
+  const vk::PhysicalDeviceFeatures device_features{
+      .shaderInt64 = physical_device_.getFeatures().shaderInt64,
+  };
 
   const vk::DeviceCreateInfo deviceCreateInfo{
       .pNext = &vulkan_12_features,
-      .queueCreateInfoCount = 1,
-      .pQueueCreateInfos = &deviceQueueCreateInfo,
+      .queueCreateInfoCount = static_cast<uint32_t>(deviceQueueCreateInfos.size()),
+      .pQueueCreateInfos = deviceQueueCreateInfos.data(),
+      .enabledExtensionCount = static_cast<uint32_t>(enabled_extensions_.size()),
+      .ppEnabledExtensionNames = enabled_extensions_.data(),
+      .pEnabledFeatures = &device_features,
   };
 
   device_ = physical_device_.createDevice(deviceCreateInfo);
 
-  // looks like I don't need this
-  compute_queue_ = device_.getQueue(compute_queue_family_index_, 0);
+  // Load device-level (and extension) entry points directly from the driver
+  VULKAN_HPP_DEFAULT_DISPATCHER.init(device_);
+
+  for (const auto &info : deviceQueueCreateInfos) {
+    if (transfer_family && info.queueFamilyIndex == *transfer_family) {
+      transfer_queue_ = QueueSlot{
+          .queue = device_.getQueue(info.queueFamilyIndex, 0),
+          .family_index = info.queueFamilyIndex,
+      };
+      continue;
+    }
+
+    for (uint32_t i = 0; i < info.queueCount; ++i) {
+      compute_queues_.push_back(QueueSlot{
+          .queue = device_.getQueue(info.queueFamilyIndex, i),
+          .family_index = info.queueFamilyIndex,
+      });
+    }
+  }
+
+  compute_queue_ = compute_queues_.front().queue;
+
+  spdlog::info("Created {} compute queue(s) in {} family(ies), dedicated transfer queue: {}",
+               compute_queues_.size(),
+               compute_families.size(),
+               transfer_queue_.has_value());
+}
+
+std::vector<uint32_t> BaseEngine::get_queue_family_indices() const {
+  std::vector<uint32_t> families;
+
+  for (const auto &slot : compute_queues_) {
+    families.push_back(slot.family_index);
+  }
+  if (transfer_queue_) {
+    families.push_back(transfer_queue_->family_index);
+  }
+
+  std::ranges::sort(families);
+  const auto [first, last] = std::ranges::unique(families);
+  families.erase(first, last);
+  return families;
+}
+
+// ----------------------------------------------------------------------------
+// Memory
+// ----------------------------------------------------------------------------
+
+void BaseEngine::detect_unified_memory() {
+  if (physical_device_.getProperties().deviceType == vk::PhysicalDeviceType::eIntegratedGpu) {
+    unified_memory_ = true;
+    spdlog::info("Memory architecture: unified");
+    return;
+  }
+
+  const auto memory_properties = physical_device_.getMemoryProperties();
+
+  unified_memory_ = true;
+  for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+    const auto flags = memory_properties.memoryTypes[i].propertyFlags;
+
+    if ((flags & vk::MemoryPropertyFlagBits::eDeviceLocal) &&
+        !(flags & vk::MemoryPropertyFlagBits::eHostVisible)) {
+      unified_memory_ = false;
+      break;
+    }
+  }
+
+  spdlog::info("Memory architecture: {}", unified_memory_ ? "unified" : "discrete");
+}
+
+// ----------------------------------------------------------------------------
+// Subgroup properties
+// ----------------------------------------------------------------------------
+
+void BaseEngine::query_subgroup_properties() {
+  vk::PhysicalDeviceVulkan13Properties vulkan13_properties{};
+  vk::PhysicalDeviceSubgroupProperties subgroup_properties{
+      .pNext = &vulkan13_properties,
+  };
+  vk::PhysicalDeviceProperties2 properties2{
+      .pNext = &subgroup_properties,
+  };
+
+  physical_device_.getProperties2(&properties2);
+
+  subgroup_size_ = subgroup_properties.subgroupSize;
+
+  // Pinning only helps if the default size is one the compute stage can require
+  subgroup_size_control_ =
+      subgroup_size_control_ &&
+      (vulkan13_properties.requiredSubgroupSizeStages & vk::ShaderStageFlagBits::eCompute) &&
+      subgroup_size_ >= vulkan13_properties.minSubgroupSize &&
+      subgroup_size_ <= vulkan13_properties.maxSubgroupSize;
+
+  spdlog::info("Subgroup size: {} (min {}, max {}, size control {})",
+               subgroup_size_,
+               vulkan13_properties.minSubgroupSize,
+               vulkan13_properties.maxSubgroupSize,
+               subgroup_size_control_);
 }
 
 // ----------------------------------------------------------------------------
@@ -249,8 +442,13 @@ void BaseEngine::initialize_vma_allocator() const {
 #pragma GCC diagnostic pop
 #endif
 
+  VmaAllocatorCreateFlags flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+  if (is_extension_enabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+    flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+  }
+
   const VmaAllocatorCreateInfo vma_allocator_create_info{
-      .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+      .flags = flags,
       .physicalDevice = physical_device_,
       .device = device_,
       .preferredLargeHeapBlockSize = 0,  // Let VMA use default size
@@ -268,4 +466,51 @@ void BaseEngine::initialize_vma_allocator() const {
   }
 }
 
+// ----------------------------------------------------------------------------
+// Queries
+// ----------------------------------------------------------------------------
+
+bool BaseEngine::is_extension_enabled(const std::string_view name) const {
+  return std::ranges::any_of(enabled_extensions_,
+                             [name](const char *ext) { return name == ext; });
+}
+
+vk::DeviceSize BaseEngine::get_host_import_alignment() const {
+  if (!is_extension_enabled(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME)) {
+    return 0;
+  }
+
+  vk::PhysicalDeviceExternalMemoryHostPropertiesEXT host_properties{};
+  vk::PhysicalDeviceProperties2 properties2{
+      .pNext = &host_properties,
+  };
+  physical_device_.getProperties2(&properties2);
+
+  return host_properties.minImportedHostPointerAlignment;
+}
+
+std::vector<HeapBudget> BaseEngine::get_heap_budgets() const {
+  const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+  vmaGetMemoryProperties(g_vma_allocator, &memory_properties);
+
+  std::vector<VmaBudget> budgets(memory_properties->memoryHeapCount);
+  vmaGetHeapBudgets(g_vma_allocator, budgets.data());
+
+  std::vector<HeapBudget> result;
+  result.reserve(budgets.size());
+
+  for (uint32_t i = 0; i < budgets.size(); ++i) {
+    result.push_back(HeapBudget{
+        .device_local =
+            (memory_properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+        .block_bytes = budgets[i].statistics.blockBytes,
+        .allocation_bytes = budgets[i].statistics.allocationBytes,
+        .usage = budgets[i].usage,
+        .budget = budgets[i].budget,
+    });
+  }
+
+  return result;
+}
+
 }  // namespace vulkan
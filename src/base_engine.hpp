@@ -1,9 +1,32 @@
 #pragma once
 
+#include <optional>
+#include <string_view>
+#include <vector>
+
 #include "vk.hpp"
 
 namespace vulkan {
 
+// Usage and budget of one memory heap, see 'BaseEngine::get_heap_budgets()'
+struct HeapBudget {
+  bool device_local = false;
+
+  // Bytes of this process in 'vk::DeviceMemory' blocks and in live allocations inside them
+  uint64_t block_bytes = 0;
+  uint64_t allocation_bytes = 0;
+
+  // Heap usage of this process and how much it can use without problems (VK_EXT_memory_budget,
+  // otherwise estimated from the heap size)
+  uint64_t usage = 0;
+  uint64_t budget = 0;
+};
+
+struct QueueSlot {
+  vk::Queue queue;
+  uint32_t family_index = 0;
+};
+
 class BaseEngine {
  public:
   explicit BaseEngine(bool enable_validation_layer = true);
@@ -16,6 +39,56 @@ class BaseEngine {
     return compute_queue_family_index_;
   }
 
+  // Every queue of every compute-capable family, the first one is 'get_compute_queue()'
+  [[nodiscard]] const std::vector<QueueSlot> &get_compute_queues() const {
+    return compute_queues_;
+  }
+
+  // Queue of a transfer-only family (DMA engine), if the device has one
+  [[nodiscard]] const std::optional<QueueSlot> &get_transfer_queue() const {
+    return transfer_queue_;
+  }
+
+  // Distinct families of all created queues, for resources shared between them
+  [[nodiscard]] std::vector<uint32_t> get_queue_family_indices() const;
+
+  [[nodiscard]] const vk::PhysicalDeviceLimits &get_limits() const { return limits_; }
+
+  // Whether all device-local memory is also host-visible (integrated GPUs), in which
+  // case mapped buffers are as fast as device-local ones and staging is unnecessary
+  [[nodiscard]] bool is_unified_memory() const { return unified_memory_; }
+
+  // Nanoseconds per timestamp tick, 0 if timestamps are not supported
+  [[nodiscard]] float get_timestamp_period() const { return limits_.timestampPeriod; }
+
+  // Meaningful bits of a timestamp written on a queue of this family, 0 if unsupported
+  [[nodiscard]] uint32_t get_timestamp_valid_bits(const uint32_t queue_family_index) const {
+    return physical_device_.getQueueFamilyProperties()[queue_family_index].timestampValidBits;
+  }
+
+  // Optional device extensions are enabled when the device supports them
+  [[nodiscard]] bool is_extension_enabled(std::string_view name) const;
+
+  // Required alignment of host pointers imported with VK_EXT_external_memory_host,
+  // 0 if the extension is not available
+  [[nodiscard]] vk::DeviceSize get_host_import_alignment() const;
+
+  // Current per-heap usage and budget, cheap enough to call before every large allocation
+  [[nodiscard]] std::vector<HeapBudget> get_heap_budgets() const;
+
+  // Default subgroup (warp/wavefront) width of the device
+  [[nodiscard]] uint32_t get_subgroup_size() const { return subgroup_size_; }
+
+  // Whether pipelines can pin their subgroup size (VK_EXT_subgroup_size_control, core in 1.3)
+  [[nodiscard]] bool supports_subgroup_size_control() const { return subgroup_size_control_; }
+
+  // Whether storage buffer descriptors can be rewritten in sets bound by recorded command
+  // buffers (descriptorBindingStorageBufferUpdateAfterBind, see 'Graph')
+  [[nodiscard]] bool supports_update_after_bind() const { return update_after_bind_; }
+
+  // Whether device timestamps can be mapped onto the host clock (VK_EXT_calibrated_timestamps)
+  [[nodiscard]] bool supports_calibrated_timestamps() const { return calibrated_timestamps_; }
+
  protected:
   void initialize_dynamic_loader();
   void request_validation_layer();
@@ -26,14 +99,26 @@ class BaseEngine {
 
   void initialize_vma_allocator() const;
 
+  void query_subgroup_properties();
+  void detect_unified_memory();
+
   // Handles
   vk::Instance instance_;
   vk::PhysicalDevice physical_device_;
   vk::Device device_;
   vk::Queue compute_queue_;
+  vk::PhysicalDeviceLimits limits_;
 
  private:
   uint32_t compute_queue_family_index_;
+  std::vector<QueueSlot> compute_queues_;
+  std::optional<QueueSlot> transfer_queue_;
+  uint32_t subgroup_size_ = 0;
+  bool subgroup_size_control_ = false;
+  bool update_after_bind_ = false;
+  bool calibrated_timestamps_ = false;
+  bool unified_memory_ = false;
+  std::vector<const char *> enabled_extensions_;
   std::vector<const char *> enabled_layers_;
 
   vk::DynamicLoader dl_;
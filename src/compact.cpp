@@ -0,0 +1,58 @@
+#include "compact.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "tracer.hpp"
+
+namespace vulkan {
+
+Compact::Compact(std::shared_ptr<Algorithm> algo,
+                 VulkanMemoryResource* mr_ptr,
+                 const CompactMode mode,
+                 const uint32_t element_bytes)
+    : algo_(std::move(algo)), mode_(mode), element_bytes_(element_bytes), tile_state_(mr_ptr) {
+  if (algo_->get_shader_name() != "prim_compact") {
+    throw std::runtime_error("Compact needs a prim_compact Algorithm, got " +
+                             algo_->get_shader_name());
+  }
+  if (element_bytes == 0 || element_bytes % 4 != 0) {
+    throw std::runtime_error("Compact element size must be a multiple of 4 bytes, got " +
+                             std::to_string(element_bytes));
+  }
+}
+
+void Compact::record(Sequence& seq,
+                     const vk::DescriptorBufferInfo& input,
+                     const vk::DescriptorBufferInfo& output,
+                     const vk::DescriptorBufferInfo& count,
+                     const uint32_t n,
+                     const std::optional<vk::DescriptorBufferInfo>& flags) {
+  spdlog::trace("Compact::record() n: {}", n);
+  const ScopedTrace trace("Compact::record");
+
+  if (flags.has_value() != (mode_ == CompactMode::kFlagged)) {
+    throw std::runtime_error(mode_ == CompactMode::kFlagged
+                                 ? "Compact was made for flagged elements"
+                                 : "Compact was made for unique elements");
+  }
+
+  // No work group would write the count
+  if (n == 0) {
+    seq.record_fill(count.buffer, count.offset, sizeof(uint32_t), 0);
+    return;
+  }
+
+  const auto num_tiles = static_cast<uint32_t>(div_ceil(n, kTileSize));
+
+  const auto tile_state = tile_state_.record(seq, num_tiles);
+
+  // Unique binds the input in place of the (never accessed) flags
+  algo_->update_push_constant(n);
+  algo_->update_buffer({input, flags.value_or(input), output, count, tile_state});
+
+  seq.record_dispatch(algo_.get(), {std::min(num_tiles, kMaxWorkGroupCount), 1, 1});
+}
+
+}  // namespace vulkan
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include "algorithm.hpp"
+#include "lookback.hpp"
+#include "sequence.hpp"
+
+namespace vulkan {
+
+enum class CompactMode {
+  kFlagged,  // keep elements with a nonzero flag
+  kUnique,   // keep the first of each run of equal elements
+};
+
+// ----------------------------------------------------------------------------
+// Compact
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Device-wide stream compaction in a single pass
+ *
+ * Backed by 'prim_compact.comp': flagging, the scan of the flags and the
+ * scatter are fused into one dispatch with decoupled look-back, so the input
+ * is read once and survivors are written once, in input order.
+ *
+ * The number of elements kept is written to 'count' on the device. Later
+ * dispatches of the same recording can consume it directly; the host can read
+ * it once 'wait()' on the submission's 'Future' returned, which also
+ * invalidates it on non-coherent memory (see 'Future').
+ *
+ * Example usage (deduplicating sorted Morton codes):
+ * ```cpp
+ * auto unique = engine.make_compact<uint32_t>(CompactMode::kUnique);
+ * seq->cmd_begin();
+ * sort->record(*seq, engine.get_buffer_info(morton_codes), n);
+ * unique->record(*seq, engine.get_buffer_info(morton_codes),
+ *                engine.get_buffer_info(unique_codes), engine.get_buffer_info(num_unique), n);
+ * seq->cmd_end();
+ * auto done = seq->launch_kernel_async();
+ * done.wait();
+ * ```
+ */
+class Compact {
+ public:
+  // Elements per work group, must match 'prim_compact.comp'
+  static constexpr uint32_t kWorkGroupSize = 256;
+  static constexpr uint32_t kTileSize = kWorkGroupSize * 4;
+
+  // 'algo' is a built 'prim_compact' Algorithm, see 'Engine::make_compact()'
+  explicit Compact(std::shared_ptr<Algorithm> algo,
+                   VulkanMemoryResource* mr_ptr,
+                   CompactMode mode,
+                   uint32_t element_bytes);
+
+  Compact(const Compact&) = delete;
+  Compact& operator=(const Compact&) = delete;
+
+  /**
+   * @brief Append a compaction of 'n' elements to the recording of 'seq'
+   * @param output Room for up to 'n' elements, must not overlap 'input'
+   * @param count One uint32_t, receives the number of elements written to 'output'
+   * @param flags 'n' uint32_t flags, required if and only if the mode is kFlagged
+   *
+   * Dispatches a work group per tile, at most 'kMaxWorkGroupCount'; past that
+   * the work groups claim the remaining tiles in turn.
+   */
+  void record(Sequence& seq,
+              const vk::DescriptorBufferInfo& input,
+              const vk::DescriptorBufferInfo& output,
+              const vk::DescriptorBufferInfo& count,
+              uint32_t n,
+              const std::optional<vk::DescriptorBufferInfo>& flags = std::nullopt);
+
+  [[nodiscard]] CompactMode get_mode() const { return mode_; }
+  [[nodiscard]] uint32_t get_element_bytes() const { return element_bytes_; }
+
+ private:
+  std::shared_ptr<Algorithm> algo_;
+  CompactMode mode_;
+  uint32_t element_bytes_;
+
+  LookbackState tile_state_;
+};
+
+}  // namespace vulkan
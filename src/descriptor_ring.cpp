@@ -0,0 +1,76 @@
+#include "descriptor_ring.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace vulkan {
+
+namespace {
+
+// Enough for a few dozen dispatches of the largest kernels (13 buffers) per pool
+constexpr uint32_t kSetsPerPool = 64;
+constexpr uint32_t kStorageBuffersPerPool = kSetsPerPool * 16;
+
+}  // namespace
+
+DescriptorRing::~DescriptorRing() {
+  for (const auto pool : pools_) {
+    device_ref_.destroyDescriptorPool(pool);
+  }
+}
+
+vk::DescriptorPool DescriptorRing::create_pool() const {
+  spdlog::trace("DescriptorRing::create_pool() pool #{}", pools_.size());
+
+  const vk::DescriptorPoolSize pool_size{
+      .type = vk::DescriptorType::eStorageBuffer,
+      .descriptorCount = kStorageBuffersPerPool,
+  };
+
+  const vk::DescriptorPoolCreateInfo create_info{
+      .maxSets = kSetsPerPool,
+      .poolSizeCount = 1,
+      .pPoolSizes = &pool_size,
+  };
+
+  return device_ref_.createDescriptorPool(create_info);
+}
+
+vk::DescriptorSet DescriptorRing::allocate(const vk::DescriptorSetLayout layout) {
+  // Move on to the next pool when the current one is exhausted, a fresh pool must fit
+  while (true) {
+    bool fresh = false;
+    if (current_ == pools_.size()) {
+      pools_.push_back(create_pool());
+      fresh = true;
+    }
+
+    const vk::DescriptorSetAllocateInfo allocate_info{
+        .descriptorPool = pools_[current_],
+        .descriptorSetCount = 1,
+        .pSetLayouts = &layout,
+    };
+
+    vk::DescriptorSet set;
+    const auto result = device_ref_.allocateDescriptorSets(&allocate_info, &set);
+    if (result == vk::Result::eSuccess) {
+      return set;
+    }
+
+    if (fresh || (result != vk::Result::eErrorOutOfPoolMemory &&
+                  result != vk::Result::eErrorFragmentedPool)) {
+      throw std::runtime_error("Failed to allocate a descriptor set: " + vk::to_string(result));
+    }
+
+    ++current_;
+  }
+}
+
+void DescriptorRing::reset() {
+  // Only pools up to the current one have sets allocated
+  for (size_t i = 0; i < pools_.size() && i <= current_; ++i) {
+    device_ref_.resetDescriptorPool(pools_[i]);
+  }
+  current_ = 0;
+}
+
+}  // namespace vulkan
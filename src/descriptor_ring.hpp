@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "vk.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// DescriptorRing
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Descriptor sets for the dispatches of one recording, freed in bulk
+ *
+ * Every dispatch gets its own set, so an Algorithm rebound between two
+ * dispatches (or used by two Sequences at once) never overwrites a set a
+ * pending command buffer still reads. Pools are created on demand and kept;
+ * 'reset()' rewinds to the first pool once the recording that used them has
+ * completed, so a steady-state loop creates no pools at all.
+ *
+ * Owned by one recording of a 'Sequence', which resets it in 'cmd_begin()'
+ * once the timeline passed that recording's last submission. Not thread safe.
+ */
+class DescriptorRing {
+ public:
+  explicit DescriptorRing(vk::Device device) : device_ref_(device) {}
+
+  ~DescriptorRing();
+
+  DescriptorRing(const DescriptorRing&) = delete;
+  DescriptorRing& operator=(const DescriptorRing&) = delete;
+
+  // Set of 'layout', valid until the next 'reset()'
+  [[nodiscard]] vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
+
+  // Free every set at once. No submission may still use them.
+  void reset();
+
+  [[nodiscard]] size_t num_pools() const { return pools_.size(); }
+
+ private:
+  vk::DescriptorPool create_pool() const;
+
+  vk::Device device_ref_;
+
+  std::vector<vk::DescriptorPool> pools_;
+  size_t current_ = 0;
+};
+
+}  // namespace vulkan
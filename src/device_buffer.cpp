@@ -0,0 +1,72 @@
+#include "device_buffer.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include "vma_pmr.hpp"
+
+extern VmaAllocator g_vma_allocator;
+
+namespace vulkan {
+
+DeviceBuffer::DeviceBuffer(const vk::DeviceSize size,
+                           const std::vector<uint32_t>& queue_family_indices,
+                           const bool host_access)
+    : size_(size) {
+  if (size == 0) {
+    throw std::runtime_error("DeviceBuffer size is 0");
+  }
+
+  const auto buffer_create_info = make_buffer_create_info(
+      size,
+      vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc |
+          vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+      queue_family_indices);
+
+  VmaAllocationCreateInfo alloc_create_info{};
+  alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+  if (host_access) {
+    alloc_create_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
+                              VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+                              VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  }
+
+  VmaAllocationInfo alloc_info{};
+  const auto result =
+      vmaCreateBuffer(g_vma_allocator,
+                      reinterpret_cast<const VkBufferCreateInfo*>(&buffer_create_info),
+                      &alloc_create_info,
+                      &buffer_,
+                      &allocation_,
+                      &alloc_info);
+
+  if (result != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create device buffer");
+  }
+
+  // With ALLOW_TRANSFER_INSTEAD the allocation is only mapped if it ended up host-visible
+  mapped_ = alloc_info.pMappedData;
+
+  VmaAllocatorInfo allocator_info{};
+  vmaGetAllocatorInfo(g_vma_allocator, &allocator_info);
+  device_address_ = vk::Device(allocator_info.device)
+                        .getBufferAddress(vk::BufferDeviceAddressInfo{.buffer = buffer_});
+
+  spdlog::debug("DeviceBuffer created, {} bytes, host-visible: {}", size_, mapped_ != nullptr);
+}
+
+DeviceBuffer::~DeviceBuffer() { vmaDestroyBuffer(g_vma_allocator, buffer_, allocation_); }
+
+void DeviceBuffer::flush(const vk::DeviceSize offset, const vk::DeviceSize size) const {
+  if (mapped_ && vmaFlushAllocation(g_vma_allocator, allocation_, offset, size) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to flush device buffer");
+  }
+}
+
+void DeviceBuffer::invalidate(const vk::DeviceSize offset, const vk::DeviceSize size) const {
+  if (mapped_ &&
+      vmaInvalidateAllocation(g_vma_allocator, allocation_, offset, size) != VK_SUCCESS) {
+    throw std::runtime_error("Failed to invalidate device buffer");
+  }
+}
+
+}  // namespace vulkan
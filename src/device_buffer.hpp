@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+
+#include <vector>
+
+#include "vk.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// DeviceBuffer
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief A storage buffer in device-local memory, the non-USM memory tier
+ *
+ * Unlike 'UsmVector' memory, a DeviceBuffer is not necessarily visible to
+ * the host. Fill and read it with 'StagingRing' (or 'Engine::upload()' /
+ * 'Engine::download()', which skip the staging copy when the buffer happens
+ * to be mapped, e.g. on integrated GPUs).
+ */
+class DeviceBuffer {
+ public:
+  /**
+   * @param size Size in bytes
+   * @param queue_family_indices Families the buffer is shared by (concurrent sharing if > 1)
+   * @param host_access Ask for memory that is both device-local and mapped if there is
+   *                    any (UMA, resizable BAR); VMA falls back to unmapped memory otherwise
+   */
+  explicit DeviceBuffer(vk::DeviceSize size,
+                        const std::vector<uint32_t>& queue_family_indices,
+                        bool host_access = false);
+
+  ~DeviceBuffer();
+
+  DeviceBuffer(const DeviceBuffer&) = delete;
+  DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+
+  [[nodiscard]] vk::Buffer get_handle() const { return buffer_; }
+  [[nodiscard]] vk::DeviceSize size() const { return size_; }
+
+  // Host pointer to the buffer, nullptr if it is not host-visible
+  [[nodiscard]] void* mapped_data() const { return mapped_; }
+  [[nodiscard]] bool is_host_visible() const { return mapped_ != nullptr; }
+
+  // Make host writes through 'mapped_data()' visible to the device (no-op when coherent)
+  void flush(vk::DeviceSize offset = 0, vk::DeviceSize size = VK_WHOLE_SIZE) const;
+
+  // Make device writes visible through 'mapped_data()' (no-op when coherent)
+  void invalidate(vk::DeviceSize offset = 0, vk::DeviceSize size = VK_WHOLE_SIZE) const;
+
+  // GPU address for bindless kernels, see 'Engine::get_device_address()'
+  [[nodiscard]] vk::DeviceAddress get_device_address(const vk::DeviceSize offset = 0) const {
+    return device_address_ + offset;
+  }
+
+  [[nodiscard]] vk::DescriptorBufferInfo get_buffer_info(
+      vk::DeviceSize offset = 0, vk::DeviceSize range = VK_WHOLE_SIZE) const {
+    return vk::DescriptorBufferInfo{
+        .buffer = buffer_,
+        .offset = offset,
+        .range = range,
+    };
+  }
+
+ private:
+  vk::DeviceSize size_;
+  VkBuffer buffer_ = VK_NULL_HANDLE;
+  VmaAllocation allocation_ = VK_NULL_HANDLE;
+  void* mapped_ = nullptr;
+  vk::DeviceAddress device_address_ = 0;
+};
+
+}  // namespace vulkan
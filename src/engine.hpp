@@ -1,25 +1,297 @@
 #pragma once
 
+#include <cstring>
+#include <span>
+#include <type_traits>
+
 #include "algorithm.hpp"
 #include "base_engine.hpp"
+#include "compact.hpp"
+#include "device_buffer.hpp"
+#include "gather.hpp"
+#include "graph.hpp"
+#include "host_buffer.hpp"
+#include "merge_sort.hpp"
+#include "pipeline_cache.hpp"
+#include "pipeline_registry.hpp"
+#include "radix_sort.hpp"
+#include "scan.hpp"
 #include "sequence.hpp"
+#include "staging_ring.hpp"
+#include "transient_pool.hpp"
 #include "vma_pmr.hpp"
 
 namespace vulkan {
 
 class Engine final : public BaseEngine {
  public:
-  explicit Engine() : BaseEngine(true), mr_ptr_(std::make_unique<VulkanMemoryResource>(device_)) {}
+  /**
+   * @brief Create the engine
+   * @param pipeline_cache_path File the pipeline cache is loaded from and saved to.
+   *                            Pass an empty string to disable persistence.
+   */
+  explicit Engine(std::string pipeline_cache_path = "kiss_vk_pipeline_cache.bin")
+      : BaseEngine(true),
+        mr_ptr_(std::make_unique<VulkanMemoryResource>(
+            device_,
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc |
+                vk::BufferUsageFlagBits::eTransferDst |
+                vk::BufferUsageFlagBits::eShaderDeviceAddress |
+                vk::BufferUsageFlagBits::eIndirectBuffer)),
+        pipeline_cache_ptr_(std::make_unique<PipelineCache>(
+            device_, physical_device_, std::move(pipeline_cache_path))),
+        registry_ptr_(
+            std::make_unique<PipelineRegistry>(device_,
+                                               pipeline_cache_ptr_->get_handle(),
+                                               supports_subgroup_size_control(),
+                                               is_extension_enabled(
+                                                   VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME))) {
+    // Buffers are shared by all queue families, see 'make_seq(queue_index)'
+    mr_ptr_->set_queue_family_indices(get_queue_family_indices());
+
+    if (const auto alignment = get_host_import_alignment(); alignment > 0) {
+      mr_ptr_->enable_host_import(alignment);
+    }
+  }
 
   [[nodiscard]] VulkanMemoryResource* get_mr() const { return mr_ptr_.get(); }
 
+  [[nodiscard]] PipelineRegistry* get_registry() const { return registry_ptr_.get(); }
+
+  // Pipelines are interned, so making the same algorithm many times is cheap.
+  // Shaders using the subgroup size constant are specialized for this device.
   [[nodiscard]] std::shared_ptr<Algorithm> make_algo(const std::string& shader_name) const {
-    return std::make_shared<Algorithm>(mr_ptr_.get(), shader_name);
+    return std::make_shared<Algorithm>(
+        mr_ptr_.get(), registry_ptr_.get(), shader_name, get_subgroup_size());
   }
 
+  // Sequences flush/invalidate USM memory for you if VMA picked non-coherent memory
   [[nodiscard]] std::shared_ptr<Sequence> make_seq() {
-    return std::make_shared<Sequence>(
+    auto seq = std::make_shared<Sequence>(
         this->get_device(), this->get_compute_queue(), this->get_compute_queue_family_index());
+    seq->set_memory_resource(mr_ptr_.get());
+    return seq;
+  }
+
+  /**
+   * @brief Make a Sequence that submits to a specific compute queue
+   * @param queue_index Index into 'get_compute_queues()', wraps around
+   *
+   * Sequences on different queues run concurrently on hardware with async
+   * compute. Order dependent work across queues with the Futures returned by
+   * 'Sequence::launch_kernel_async()'. A queue must not be submitted to from
+   * two threads at the same time, so give each thread its own queue index.
+   */
+  [[nodiscard]] std::shared_ptr<Sequence> make_seq(const size_t queue_index) {
+    const auto& slot = get_compute_queues()[queue_index % get_compute_queues().size()];
+    auto seq = std::make_shared<Sequence>(this->get_device(), slot.queue, slot.family_index);
+    seq->set_memory_resource(mr_ptr_.get());
+    return seq;
+  }
+
+  // Sequence on the dedicated transfer queue (copies only), or the default compute queue
+  [[nodiscard]] std::shared_ptr<Sequence> make_transfer_seq() {
+    if (const auto& slot = get_transfer_queue()) {
+      auto seq = std::make_shared<Sequence>(
+          this->get_device(), slot->queue, slot->family_index, vk::QueueFlagBits::eTransfer);
+      seq->set_memory_resource(mr_ptr_.get());
+      return seq;
+    }
+    return make_seq();
+  }
+
+  // Sequence that times every dispatch, read with 'Sequence::get_timings()' after 'sync()'
+  [[nodiscard]] std::shared_ptr<Sequence> make_profiled_seq(const size_t queue_index = 0,
+                                                           const uint32_t max_dispatches = 256) {
+    auto seq = make_seq(queue_index);
+    const auto& slot = get_compute_queues()[queue_index % get_compute_queues().size()];
+    seq->enable_profiling(get_timestamp_period(),
+                          get_timestamp_valid_bits(slot.family_index),
+                          max_dispatches,
+                          supports_calibrated_timestamps());
+    return seq;
+  }
+
+  // A graph owns its own sequence (command buffer)
+  [[nodiscard]] std::shared_ptr<Graph> make_graph() {
+    return std::make_shared<Graph>(
+        make_seq(), mr_ptr_.get(), registry_ptr_.get(), supports_update_after_bind());
+  }
+
+  // ---------------------------------------------------------------------------
+  // Device-wide primitives
+  // ---------------------------------------------------------------------------
+
+  // Single-pass prefix sum; int and uint share a pipeline (two's complement)
+  [[nodiscard]] std::shared_ptr<Scan> make_scan(const ElementType type = ElementType::kUint) const {
+    auto algo = make_algo("prim_scan")
+                    ->work_group_size(Scan::kWorkGroupSize, 1, 1)
+                    ->specialization_constant(2, type == ElementType::kFloat ? 1u : 0u)
+                    ->build();
+    return std::make_shared<Scan>(std::move(algo), mr_ptr_.get());
+  }
+
+  // Stable sort of 32- or 64-bit keys, moving a 'value_bytes' payload with each key
+  [[nodiscard]] std::shared_ptr<RadixSort> make_radix_sort(const uint32_t key_bits = 32,
+                                                           const uint32_t value_bytes = 0) const {
+    const auto make = [&](const std::string& shader_name) {
+      return make_algo(shader_name)
+          ->work_group_size(RadixSort::kWorkGroupSize, 1, 1)
+          ->specialization_constant(2, key_bits / 32);
+    };
+
+    const uint32_t value_words = value_bytes / 4;
+    RadixSort::Kernels kernels{
+        .histogram = make("prim_radix_histogram")->build(),
+        .upsweep = make("prim_radix_upsweep")->build(),
+        .downsweep = make("prim_radix_downsweep")->specialization_constant(3, value_words)->build(),
+        .copy = make("prim_radix_copy")->specialization_constant(3, value_words)->build(),
+        .iota = make_algo("prim_iota")->work_group_size(RadixSort::kWorkGroupSize, 1, 1)->build(),
+    };
+
+    return std::make_shared<RadixSort>(
+        std::move(kernels), make_scan(ElementType::kUint), mr_ptr_.get(), key_bits, value_bytes);
+  }
+
+  /**
+   * @brief Radix sort moving a 'Value' with each 'Key'
+   * @tparam Key uint32_t or uint64_t
+   * @tparam Value uint32_t for point indices, or any trivially copyable struct of 4-byte words
+   *
+   * Example usage:
+   * ```cpp
+   * struct PointAttributes {
+   *   float intensity;
+   *   uint32_t rgba;
+   * };
+   * auto sort = engine.make_key_value_sort<uint32_t, PointAttributes>();
+   * sort->record(*seq, engine.get_buffer_info(morton_codes), n,
+   *              engine.get_buffer_info(attributes));
+   * ```
+   */
+  template <typename Key, typename Value>
+  [[nodiscard]] std::shared_ptr<RadixSort> make_key_value_sort() const {
+    static_assert(std::is_same_v<Key, uint32_t> || std::is_same_v<Key, uint64_t>,
+                  "Radix sort keys must be uint32_t or uint64_t");
+    static_assert(std::is_trivially_copyable_v<Value> && sizeof(Value) % 4 == 0,
+                  "Values must be trivially copyable and a multiple of 4 bytes");
+    return make_radix_sort(sizeof(Key) * 8, sizeof(Value));
+  }
+
+  // Stable comparison sort for keys radix sort can't order by their bits (signed, float, 64-bit)
+  [[nodiscard]] std::shared_ptr<MergeSort> make_merge_sort(const SortKeyType key_type,
+                                                           const uint32_t value_bytes = 0,
+                                                           const bool descending = false) const {
+    const auto make = [&](const std::string& shader_name) {
+      return make_algo(shader_name)
+          ->work_group_size(MergeSort::kWorkGroupSize, 1, 1)
+          ->specialization_constant(2, static_cast<uint32_t>(key_type))
+          ->specialization_constant(4, descending);
+    };
+
+    const uint32_t value_words = value_bytes / 4;
+    MergeSort::Kernels kernels{
+        .block_sort =
+            make("prim_merge_block_sort")->specialization_constant(3, value_words)->build(),
+        .partition = make("prim_merge_partition")->build(),
+        .merge = make("prim_merge_pass")->specialization_constant(3, value_words)->build(),
+    };
+
+    return std::make_shared<MergeSort>(std::move(kernels), mr_ptr_.get(), key_type, value_bytes);
+  }
+
+  // dst[i] = src[indices[i]] for elements of 'element_bytes' (a multiple of 4)
+  [[nodiscard]] std::shared_ptr<Gather> make_gather(const uint32_t element_bytes) const {
+    auto algo = make_algo("prim_gather")
+                    ->work_group_size(Gather::kWorkGroupSize, 1, 1)
+                    ->specialization_constant(2, element_bytes / 4)
+                    ->build();
+    return std::make_shared<Gather>(std::move(algo), element_bytes);
+  }
+
+  template <typename T>
+  [[nodiscard]] std::shared_ptr<Gather> make_gather() const {
+    static_assert(std::is_trivially_copyable_v<T>, "Gathered elements must be trivially copyable");
+    return make_gather(sizeof(T));
+  }
+
+  // Single-pass stream compaction / unique of elements of 'element_bytes' (a multiple of 4)
+  [[nodiscard]] std::shared_ptr<Compact> make_compact(const CompactMode mode,
+                                                      const uint32_t element_bytes = 4) const {
+    auto algo = make_algo("prim_compact")
+                    ->work_group_size(Compact::kWorkGroupSize, 1, 1)
+                    ->specialization_constant(2, mode == CompactMode::kUnique ? 1u : 0u)
+                    ->specialization_constant(3, element_bytes / 4)
+                    ->build();
+    return std::make_shared<Compact>(std::move(algo), mr_ptr_.get(), mode, element_bytes);
+  }
+
+  template <typename T>
+  [[nodiscard]] std::shared_ptr<Compact> make_compact(const CompactMode mode) const {
+    static_assert(std::is_trivially_copyable_v<T>, "Compacted elements must be trivially copyable");
+    return make_compact(mode, sizeof(T));
+  }
+
+  // ---------------------------------------------------------------------------
+  // Device-local memory tier
+  // ---------------------------------------------------------------------------
+
+  // Device-local buffer; on unified memory it is also mapped, so transfers skip staging
+  [[nodiscard]] std::shared_ptr<DeviceBuffer> make_device_buffer(const vk::DeviceSize size) const {
+    return std::make_shared<DeviceBuffer>(size, get_queue_family_indices(), is_unified_memory());
+  }
+
+  // Engine-wide staging ring on the transfer queue, created on first use
+  [[nodiscard]] StagingRing& get_staging() {
+    if (!staging_ptr_) {
+      staging_ptr_ = std::make_unique<StagingRing>(
+          make_transfer_seq(), make_transfer_seq(), get_queue_family_indices());
+    }
+    return *staging_ptr_;
+  }
+
+  // Blocking upload, a plain copy when the buffer is mapped
+  template <typename T>
+  void upload(const DeviceBuffer& dst, std::span<const T> src, const vk::DeviceSize offset = 0) {
+    const auto bytes = src.size_bytes();
+    if (offset + bytes > dst.size()) {
+      throw std::runtime_error("Upload exceeds the device buffer");
+    }
+
+    if (dst.is_host_visible()) {
+      std::memcpy(static_cast<std::byte*>(dst.mapped_data()) + offset, src.data(), bytes);
+      dst.flush(offset, bytes);
+    } else {
+      get_staging().upload(src.data(), dst.get_handle(), offset, bytes);
+    }
+  }
+
+  // Blocking download, the GPU work writing 'src' must have completed
+  template <typename T>
+  void download(const DeviceBuffer& src, std::span<T> dst, const vk::DeviceSize offset = 0) {
+    const auto bytes = dst.size_bytes();
+    if (offset + bytes > src.size()) {
+      throw std::runtime_error("Download exceeds the device buffer");
+    }
+
+    if (src.is_host_visible()) {
+      src.invalidate(offset, bytes);
+      std::memcpy(dst.data(), static_cast<const std::byte*>(src.mapped_data()) + offset, bytes);
+    } else {
+      get_staging().download(src.get_handle(), offset, dst.data(), bytes);
+    }
+  }
+
+  // Zero-copy GPU view of foreign host memory, falls back to a single copy
+  [[nodiscard]] std::shared_ptr<HostBuffer> import_host(void* ptr, const size_t bytes) const {
+    return std::make_shared<HostBuffer>(
+        mr_ptr_.get(), ptr, bytes, get_limits().minStorageBufferOffsetAlignment);
+  }
+
+  // Lifetime-aliased temporaries for multi-stage pipelines, backed by USM memory
+  [[nodiscard]] std::shared_ptr<TransientPool> make_transient_pool() const {
+    return std::make_shared<TransientPool>(mr_ptr_.get(),
+                                           get_limits().minStorageBufferOffsetAlignment);
   }
 
   // To get a 'vk::Buffer' from raw pointer of the 'UsmVector'
@@ -27,25 +299,90 @@ class Engine final : public BaseEngine {
     return mr_ptr_->get_buffer_from_pointer(ptr);
   }
 
+  // Works for dedicated and arena allocations (see 'VulkanMemoryResource::enable_arena()')
   template <typename T>
   [[nodiscard]]
   vk::DescriptorBufferInfo get_buffer_info(std::pmr::vector<T>& vec) const {
-    auto vk_buffer = get_buffer(vec.data());
+    const auto slice = mr_ptr_->get_buffer_slice(vec.data());
 
-    spdlog::trace("get_buffer_info: vec.data() = {}, vk_buffer = {}, vec.size() = {}",
+    spdlog::trace("get_buffer_info: vec.data() = {}, vk_buffer = {}, offset = {}, vec.size() = {}",
                   static_cast<void*>(vec.data()),
-                  static_cast<void*>(vk_buffer),
+                  static_cast<void*>(slice.buffer),
+                  slice.offset,
                   vec.size());
 
     return vk::DescriptorBufferInfo{
-        .buffer = get_buffer(vec.data()),
-        .offset = 0,
+        .buffer = slice.buffer,
+        .offset = slice.offset,
         .range = vec.size() * sizeof(T),
     };
   }
 
+  /**
+   * @brief Bind a slice of a USM allocation without copying it
+   * @param ptr Any pointer into a live allocation, e.g. 'vec.data() + k'
+   * @param count Number of elements from 'ptr'
+   *
+   * The byte offset of 'ptr' in its buffer must be a multiple of
+   * 'minStorageBufferOffsetAlignment', otherwise this throws.
+   *
+   * Example usage:
+   * ```cpp
+   * algo->update_buffer({engine.get_buffer_info(scan.data() + n_blocks, n_blocks)});
+   * ```
+   */
+  template <typename T>
+  [[nodiscard]]
+  vk::DescriptorBufferInfo get_buffer_info(const T* ptr, const size_t count) const {
+    const auto slice = mr_ptr_->get_buffer_slice(ptr);
+
+    if (slice.offset % get_limits().minStorageBufferOffsetAlignment != 0) {
+      throw std::runtime_error("Buffer slice offset is not aligned to "
+                               "minStorageBufferOffsetAlignment");
+    }
+    if (count * sizeof(T) > slice.size) {
+      throw std::runtime_error("Buffer slice exceeds its allocation");
+    }
+
+    return vk::DescriptorBufferInfo{
+        .buffer = slice.buffer,
+        .offset = slice.offset,
+        .range = count * sizeof(T),
+    };
+  }
+
+  /**
+   * @brief GPU address of USM memory, for bindless kernels
+   * @param ptr Any pointer into a live allocation, e.g. 'vec.data() + k'
+   *
+   * Kernels without descriptor bindings take their buffers as
+   * 'GL_EXT_buffer_reference' pointers in the push constants instead.
+   *
+   * Example usage:
+   * ```cpp
+   * // shader: layout(push_constant) uniform Params { PointsRef points; CodesRef codes; uint n; };
+   * struct Params {
+   *   vk::DeviceAddress points;
+   *   vk::DeviceAddress codes;
+   *   uint32_t n;
+   * };
+   * algo->update_push_constant(Params{
+   *     .points = engine.get_device_address(points.data()),
+   *     .codes = engine.get_device_address(codes.data()),
+   *     .n = n,
+   * });
+   * ```
+   */
+  template <typename T>
+  [[nodiscard]] vk::DeviceAddress get_device_address(const T* ptr) const {
+    return mr_ptr_->get_buffer_slice(ptr).device_address;
+  }
+
  private:
   std::unique_ptr<VulkanMemoryResource> mr_ptr_;
+  std::unique_ptr<PipelineCache> pipeline_cache_ptr_;
+  std::unique_ptr<PipelineRegistry> registry_ptr_;
+  std::unique_ptr<StagingRing> staging_ptr_;
 };
 
 }  // namespace vulkan
\ No newline at end of file
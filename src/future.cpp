@@ -0,0 +1,59 @@
+#include "future.hpp"
+
+#include <stdexcept>
+
+#include "sequence.hpp"
+
+namespace vulkan {
+
+void Future::wait() const {
+  if (!wait_for(std::chrono::nanoseconds::max())) {
+    throw std::runtime_error("Failed to wait for future");
+  }
+}
+
+bool Future::wait_for(const std::chrono::nanoseconds timeout) const {
+  if (!valid() || owner_destroyed()) {
+    return true;
+  }
+
+  const vk::SemaphoreWaitInfo wait_info{
+      .semaphoreCount = 1,
+      .pSemaphores = &semaphore_ref_,
+      .pValues = &value_,
+  };
+
+  const auto result =
+      device_ref_.waitSemaphores(wait_info, static_cast<uint64_t>(timeout.count()));
+
+  if (result == vk::Result::eTimeout) {
+    return false;
+  }
+  if (result != vk::Result::eSuccess) {
+    throw std::runtime_error("Failed to wait for timeline semaphore");
+  }
+
+  complete();
+  return true;
+}
+
+bool Future::ready() const {
+  if (!valid() || owner_destroyed()) {
+    return true;
+  }
+
+  if (device_ref_.getSemaphoreCounterValue(semaphore_ref_) < value_) {
+    return false;
+  }
+
+  complete();
+  return true;
+}
+
+void Future::complete() const {
+  if (const auto owner = owner_.lock()) {
+    owner->on_complete(value_);
+  }
+}
+
+}  // namespace vulkan
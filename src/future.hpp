@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "vk.hpp"
+
+namespace vulkan {
+
+class Sequence;
+
+// ----------------------------------------------------------------------------
+// Future
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Ticket for one GPU submission, backed by a timeline semaphore
+ *
+ * The submission is complete once the semaphore counter reaches 'value'.
+ * A Future is two handles, a counter and a weak reference to its Sequence, so
+ * it is cheap to copy and to pass to another submission as a GPU-side
+ * dependency (see 'Sequence::launch_kernel_async()').
+ *
+ * A default-constructed Future is already complete. A Future may outlive the
+ * Sequence that issued it: the Sequence waits for its submissions when
+ * destroyed, so afterwards the Future reports complete without touching the
+ * semaphore, which was destroyed with the Sequence.
+ *
+ * Once 'wait()', 'wait_for()' or 'ready()' sees the latest submission of its
+ * Sequence complete, the ranges it wrote are invalidated like in
+ * 'Sequence::sync()', so results in non-coherent memory can be read right
+ * away. Like the Sequence, this is not thread safe: wait on the thread that
+ * uses the Sequence, or call 'Sequence::sync()' there before reading.
+ */
+class Future {
+ public:
+  Future() = default;
+
+  Future(const vk::Device device,
+         const vk::Semaphore semaphore,
+         const uint64_t value,
+         std::weak_ptr<Sequence> owner = {})
+      : device_ref_(device),
+        semaphore_ref_(semaphore),
+        value_(value),
+        owner_(std::move(owner)),
+        has_owner_(!owner_.expired()) {}
+
+  // Block until the submission completed
+  void wait() const;
+
+  // Block for at most 'timeout', returns whether the submission completed
+  [[nodiscard]] bool wait_for(std::chrono::nanoseconds timeout) const;
+
+  // Non-blocking poll
+  [[nodiscard]] bool ready() const;
+
+  [[nodiscard]] bool valid() const { return static_cast<bool>(semaphore_ref_); }
+
+  [[nodiscard]] vk::Semaphore get_semaphore() const { return semaphore_ref_; }
+  [[nodiscard]] uint64_t get_value() const { return value_; }
+
+ private:
+  // Lets the issuing Sequence finish host-side work of a completed submission
+  void complete() const;
+
+  // The semaphore is gone with a destroyed Sequence, which completed everything first
+  [[nodiscard]] bool owner_destroyed() const { return has_owner_ && owner_.expired(); }
+
+  vk::Device device_ref_;
+  vk::Semaphore semaphore_ref_;
+  uint64_t value_ = 0;
+  std::weak_ptr<Sequence> owner_;
+  bool has_owner_ = false;
+};
+
+}  // namespace vulkan
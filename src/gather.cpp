@@ -0,0 +1,35 @@
+#include "gather.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace vulkan {
+
+Gather::Gather(std::shared_ptr<Algorithm> algo, const uint32_t element_bytes)
+    : algo_(std::move(algo)), element_bytes_(element_bytes) {
+  if (element_bytes_ == 0 || element_bytes_ % 4 != 0) {
+    throw std::runtime_error("Gather element size must be a multiple of 4 bytes, got " +
+                             std::to_string(element_bytes_));
+  }
+}
+
+void Gather::record(Sequence& seq,
+                    const vk::DescriptorBufferInfo& indices,
+                    const vk::DescriptorBufferInfo& src,
+                    const vk::DescriptorBufferInfo& dst,
+                    const uint32_t n) {
+  spdlog::trace("Gather::record() n: {}", n);
+
+  if (n == 0) {
+    return;
+  }
+
+  algo_->update_push_constant(n);
+  algo_->update_buffer({indices, src, dst});
+
+  const auto num_groups = static_cast<uint32_t>(div_ceil(n, kWorkGroupSize));
+  seq.record_dispatch(algo_.get(), {std::min(num_groups, kMaxWorkGroupCount), 1, 1});
+}
+
+}  // namespace vulkan
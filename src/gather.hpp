@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+
+#include "algorithm.hpp"
+#include "sequence.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// Gather
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Apply a permutation to a buffer of fixed-size elements: dst[i] = src[indices[i]]
+ *
+ * Used after a key-value sort that carried point indices, to bring colour,
+ * intensity, normals, ... into the sorted order on the device.
+ *
+ * Example usage:
+ * ```cpp
+ * auto sort = engine.make_key_value_sort<uint32_t, uint32_t>();
+ * auto gather = engine.make_gather<glm::vec4>();
+ * seq->cmd_begin();
+ * sort->record_argsort(*seq, engine.get_buffer_info(morton_codes), n,
+ *                      engine.get_buffer_info(order));
+ * gather->record(*seq, engine.get_buffer_info(order), engine.get_buffer_info(colors),
+ *                engine.get_buffer_info(sorted_colors), n);
+ * seq->cmd_end();
+ * ```
+ */
+class Gather {
+ public:
+  static constexpr uint32_t kWorkGroupSize = 256;
+
+  // 'algo' is a built 'prim_gather' Algorithm, see 'Engine::make_gather()'
+  explicit Gather(std::shared_ptr<Algorithm> algo, uint32_t element_bytes);
+
+  Gather(const Gather&) = delete;
+  Gather& operator=(const Gather&) = delete;
+
+  // 'dst' must not overlap 'src'. Past 'kMaxWorkGroupCount' work groups, each covers several
+  // elements with a grid stride.
+  void record(Sequence& seq,
+              const vk::DescriptorBufferInfo& indices,
+              const vk::DescriptorBufferInfo& src,
+              const vk::DescriptorBufferInfo& dst,
+              uint32_t n);
+
+  [[nodiscard]] uint32_t get_element_bytes() const { return element_bytes_; }
+
+ private:
+  std::shared_ptr<Algorithm> algo_;
+  uint32_t element_bytes_;
+};
+
+}  // namespace vulkan
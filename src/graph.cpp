@@ -0,0 +1,410 @@
+#include "graph.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "tracer.hpp"
+
+namespace vulkan {
+
+namespace {
+
+[[nodiscard]] bool overlaps(const vk::DescriptorBufferInfo& a, const vk::DescriptorBufferInfo& b) {
+  if (a.buffer != b.buffer) {
+    return false;
+  }
+
+  constexpr auto kEnd = std::numeric_limits<vk::DeviceSize>::max();
+  const auto a_end = a.range == VK_WHOLE_SIZE ? kEnd : a.offset + a.range;
+  const auto b_end = b.range == VK_WHOLE_SIZE ? kEnd : b.offset + b.range;
+  return a.offset < b_end && b.offset < a_end;
+}
+
+}  // namespace
+
+Graph::Graph(std::shared_ptr<Sequence> seq,
+             VulkanMemoryResource* mr_ptr,
+             PipelineRegistry* registry_ptr,
+             const bool update_after_bind)
+    : seq_(std::move(seq)),
+      mr_ptr_(mr_ptr),
+      registry_ptr_(registry_ptr),
+      update_after_bind_(update_after_bind),
+      grid_sizes_(mr_ptr),
+      params_(mr_ptr) {
+  spdlog::trace("Graph constructor, update-after-bind: {}", update_after_bind_);
+}
+
+Graph::~Graph() {
+  spdlog::trace("Graph destructor");
+
+  seq_->sync();
+
+  if (descriptor_pool_) {
+    registry_ptr_->get_device().destroyDescriptorPool(descriptor_pool_);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Building / patching
+// ----------------------------------------------------------------------------
+
+size_t Graph::add_node(std::shared_ptr<Algorithm> algo, const std::array<uint32_t, 3> grid_size) {
+  // The grid size and parameter buffers may move
+  last_launch_.wait();
+
+  const auto push_constants = algo->get_push_constants();
+  const auto& buffer_infos = algo->get_buffer_infos();
+
+  DispatchBinding binding{};
+  if (update_after_bind_ && !algo->is_bindless()) {
+    auto key = algo->get_pipeline_key();
+    key.update_after_bind = true;
+
+    binding.pipeline = registry_ptr_->get_pipeline(key);
+    binding.pipeline_layout =
+        registry_ptr_->get_pipeline_layout(key.num_buffers, key.push_constant_size, true);
+  }
+
+  nodes_.push_back(Node{
+      .algo = std::move(algo),
+      .push_constants = {push_constants.begin(), push_constants.end()},
+      .buffer_infos = buffer_infos,
+      .binding = binding,
+  });
+  grid_sizes_.push_back(vk::DispatchIndirectCommand{
+      .x = grid_size[0],
+      .y = grid_size[1],
+      .z = grid_size[2],
+  });
+  params_.emplace_back();
+
+  dirty_ = true;
+  return nodes_.size() - 1;
+}
+
+size_t Graph::add_node(std::shared_ptr<Algorithm> algo,
+                       const std::array<uint32_t, 3> grid_size,
+                       const void* params_ptr,
+                       const size_t params_size) {
+  if (algo->is_bindless()) {
+    throw std::runtime_error("Parameter blocks need a descriptor binding");
+  }
+
+  if (params_size == 0 || params_size > kMaxParamsSize) {
+    throw std::runtime_error("Parameter block must hold 1 to " + std::to_string(kMaxParamsSize) +
+                             " bytes");
+  }
+
+  const auto node = add_node(std::move(algo), grid_size);
+  nodes_[node].params_size = params_size;
+  std::memcpy(params_[node].data.data(), params_ptr, params_size);
+  return node;
+}
+
+void Graph::update_push_constant(const size_t node,
+                                 const void* data_ptr,
+                                 const size_t size_in_bytes) {
+  auto& n = nodes_.at(node);
+
+  if (size_in_bytes != n.push_constants.size()) {
+    throw std::runtime_error("Push constant size mismatch");
+  }
+
+  // Push constants are part of the recording, unchanged ones keep it
+  if (std::memcmp(n.push_constants.data(), data_ptr, size_in_bytes) != 0) {
+    std::memcpy(n.push_constants.data(), data_ptr, size_in_bytes);
+    dirty_ = true;
+  }
+}
+
+void Graph::update_params(const size_t node, const void* data_ptr, const size_t size_in_bytes) {
+  const auto& n = nodes_.at(node);
+
+  if (n.params_size == 0) {
+    throw std::runtime_error("Graph node has no parameter block");
+  }
+
+  if (size_in_bytes != n.params_size) {
+    throw std::runtime_error("Parameter block size mismatch");
+  }
+
+  auto& slot = params_[node].data;
+  if (std::memcmp(slot.data(), data_ptr, size_in_bytes) == 0) {
+    return;
+  }
+
+  // Read by the previous launch, flushed with the node's buffers at launch
+  last_launch_.wait();
+  std::memcpy(slot.data(), data_ptr, size_in_bytes);
+}
+
+void Graph::update_buffer(const size_t node,
+                          const std::initializer_list<vk::DescriptorBufferInfo> buffer_infos) {
+  auto& n = nodes_.at(node);
+
+  auto new_infos = n.params_size > 0
+                       ? with_params(node, buffer_infos)
+                       : std::vector<vk::DescriptorBufferInfo>(buffer_infos);
+
+  if (std::ranges::equal(n.buffer_infos, new_infos)) {
+    return;
+  }
+
+  // Barriers were placed for the old overlaps, a different pattern needs a new recording
+  const bool in_place = !dirty_ && n.binding.descriptor_set && same_overlaps(node, new_infos);
+
+  n.buffer_infos = std::move(new_infos);
+
+  if (in_place) {
+    last_launch_.wait();
+    write_descriptor_set(n);
+  } else {
+    dirty_ = true;
+  }
+}
+
+void Graph::update_grid_size(const size_t node, const std::array<uint32_t, 3> grid_size) {
+  auto& cmd = grid_sizes_.at(node);
+
+  if (cmd.x == grid_size[0] && cmd.y == grid_size[1] && cmd.z == grid_size[2]) {
+    return;
+  }
+
+  // Read by the indirect dispatch, the Sequence flushes it at launch
+  last_launch_.wait();
+  cmd = vk::DispatchIndirectCommand{.x = grid_size[0], .y = grid_size[1], .z = grid_size[2]};
+}
+
+// ----------------------------------------------------------------------------
+// Descriptor sets
+// ----------------------------------------------------------------------------
+
+void Graph::create_descriptor_sets() {
+  const auto device = registry_ptr_->get_device();
+
+  if (descriptor_pool_) {
+    device.destroyDescriptorPool(descriptor_pool_);
+    descriptor_pool_ = nullptr;
+  }
+
+  uint32_t num_sets = 0;
+  uint32_t num_descriptors = 0;
+  for (const auto& node : nodes_) {
+    if (node.binding.pipeline) {
+      ++num_sets;
+      num_descriptors += static_cast<uint32_t>(node.algo->get_num_buffers());
+    }
+  }
+
+  if (num_sets == 0) {
+    return;
+  }
+
+  const vk::DescriptorPoolSize pool_size{
+      .type = vk::DescriptorType::eStorageBuffer,
+      .descriptorCount = num_descriptors,
+  };
+  descriptor_pool_ = device.createDescriptorPool(vk::DescriptorPoolCreateInfo{
+      .flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+      .maxSets = num_sets,
+      .poolSizeCount = 1,
+      .pPoolSizes = &pool_size,
+  });
+
+  for (auto& node : nodes_) {
+    if (!node.binding.pipeline) {
+      continue;
+    }
+
+    const auto set_layout =
+        registry_ptr_->get_descriptor_set_layout(node.algo->get_num_buffers(), true);
+    node.binding.descriptor_set = device
+                                      .allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+                                          .descriptorPool = descriptor_pool_,
+                                          .descriptorSetCount = 1,
+                                          .pSetLayouts = &set_layout,
+                                      })
+                                      .front();
+    write_descriptor_set(node);
+  }
+}
+
+void Graph::write_descriptor_set(const Node& node) const {
+  if (node.buffer_infos.size() != node.algo->get_num_buffers()) {
+    throw std::runtime_error("Graph node needs one buffer per binding");
+  }
+
+  std::vector<vk::WriteDescriptorSet> writes;
+  writes.reserve(node.buffer_infos.size());
+
+  for (uint32_t i = 0; i < node.buffer_infos.size(); ++i) {
+    writes.push_back(vk::WriteDescriptorSet{
+        .dstSet = node.binding.descriptor_set,
+        .dstBinding = i,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .pBufferInfo = &node.buffer_infos[i],
+    });
+  }
+
+  registry_ptr_->get_device().updateDescriptorSets(writes, {});
+}
+
+bool Graph::same_overlaps(const size_t node,
+                          const std::span<const vk::DescriptorBufferInfo> buffer_infos) const {
+  const auto& old_infos = nodes_[node].buffer_infos;
+  if (old_infos.size() != buffer_infos.size()) {
+    return false;
+  }
+
+  for (size_t other = 0; other < nodes_.size(); ++other) {
+    if (other == node) {
+      continue;
+    }
+    for (const auto& info : nodes_[other].buffer_infos) {
+      for (size_t i = 0; i < buffer_infos.size(); ++i) {
+        if (overlaps(old_infos[i], info) != overlaps(buffer_infos[i], info)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+vk::DescriptorBufferInfo Graph::get_grid_size_info(const size_t node) const {
+  const auto slice = mr_ptr_->get_buffer_slice(&grid_sizes_[node]);
+  return vk::DescriptorBufferInfo{
+      .buffer = slice.buffer,
+      .offset = slice.offset,
+      .range = sizeof(vk::DispatchIndirectCommand),
+  };
+}
+
+vk::DescriptorBufferInfo Graph::get_params_info(const size_t node) const {
+  const auto slice = mr_ptr_->get_buffer_slice(&params_[node]);
+  return vk::DescriptorBufferInfo{
+      .buffer = slice.buffer,
+      .offset = slice.offset,
+      .range = sizeof(ParamsSlot),
+  };
+}
+
+std::vector<vk::DescriptorBufferInfo> Graph::with_params(
+    const size_t node, const std::span<const vk::DescriptorBufferInfo> buffer_infos) const {
+  std::vector<vk::DescriptorBufferInfo> result(buffer_infos.begin(), buffer_infos.end());
+
+  // The last binding may be left out, it is always the parameter block
+  if (result.size() < nodes_[node].algo->get_num_buffers()) {
+    result.emplace_back();
+  }
+  result.back() = get_params_info(node);
+
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+// Recording / launching
+// ----------------------------------------------------------------------------
+
+void Graph::record() {
+  spdlog::trace("Graph::record() {} nodes", nodes_.size());
+  const ScopedTrace trace("Graph::record");
+
+  // Descriptor sets and the command buffer must not be touched while in use
+  seq_->sync();
+
+  // Nodes added since the last recording may have moved the parameter blocks
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    if (nodes_[i].params_size > 0) {
+      nodes_[i].buffer_infos = with_params(i, nodes_[i].buffer_infos);
+    }
+  }
+
+  create_descriptor_sets();
+
+  seq_->cmd_begin(false);
+
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    const auto& node = nodes_[i];
+
+    if (!node.push_constants.empty()) {
+      node.algo->update_push_constant(node.push_constants.data(), node.push_constants.size());
+    }
+    // Also gives the Sequence the ranges it places barriers by
+    if (!node.buffer_infos.empty()) {
+      node.algo->update_buffer(node.buffer_infos);
+    }
+
+    seq_->record_dispatch_indirect(node.algo.get(),
+                                   get_grid_size_info(i),
+                                   node.binding.pipeline ? &node.binding : nullptr);
+  }
+
+  seq_->cmd_end();
+
+  dirty_ = false;
+  ++num_recordings_;
+}
+
+void Graph::flush_buffers() const {
+  if (!mr_ptr_->has_non_coherent_memory()) {
+    return;
+  }
+
+  for (const auto& node : nodes_) {
+    for (uint32_t i = 0; i < node.buffer_infos.size(); ++i) {
+      if (node.algo->get_buffer_access(i) != BufferAccess::kWriteOnly) {
+        const auto& info = node.buffer_infos[i];
+        mr_ptr_->flush_range(info.buffer, info.offset, info.range);
+      }
+    }
+  }
+}
+
+void Graph::invalidate_buffers() const {
+  if (!mr_ptr_->has_non_coherent_memory()) {
+    return;
+  }
+
+  for (const auto& node : nodes_) {
+    for (uint32_t i = 0; i < node.buffer_infos.size(); ++i) {
+      if (node.algo->get_buffer_access(i) != BufferAccess::kReadOnly) {
+        const auto& info = node.buffer_infos[i];
+        mr_ptr_->invalidate_range(info.buffer, info.offset, info.range);
+      }
+    }
+  }
+}
+
+Future Graph::launch_async(const std::span<const Future> wait_on) {
+  spdlog::trace("Graph::launch_async()");
+
+  if (nodes_.empty()) {
+    throw std::runtime_error("Graph has no nodes");
+  }
+
+  if (dirty_) {
+    record();
+  }
+
+  flush_buffers();
+
+  last_launch_ = seq_->launch_kernel_async(wait_on);
+  return last_launch_;
+}
+
+void Graph::sync() {
+  spdlog::trace("Graph::sync()");
+
+  seq_->sync();
+  invalidate_buffers();
+}
+
+}  // namespace vulkan
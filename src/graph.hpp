@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "sequence.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// Graph
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief A captured list of dispatches that is recorded once and replayed
+ *
+ * Nodes snapshot the push constants and buffers of their Algorithm when they
+ * are added. The command buffer is recorded on the first launch and then
+ * resubmitted as-is. Patches go to memory the recording reads, not to the
+ * recording:
+ *   - grid sizes are read by indirect dispatches from a host-visible buffer
+ *   - parameter blocks (see the 'add_node()' overload) live in a host-visible
+ *     buffer too, one slot per node bound as the kernel's last binding
+ *   - every node binds its own update-after-bind descriptor set, and new
+ *     buffers are written into it in place
+ *
+ * The graph is recorded again only when its shape changes: a node is added,
+ * a push constant changes (push constants live in the command buffer), or a
+ * buffer patch changes which nodes' buffers overlap, which moves barriers.
+ * Per-launch values that should not cost a recording belong in a parameter
+ * block instead of push constants. Devices without update-after-bind storage
+ * buffers ('BaseEngine::supports_update_after_bind()') also record again on
+ * buffer patches.
+ *
+ * In-place patches block the host until the previous launch completes, since
+ * it may still read the old values. Patch before 'launch_async()' rather than
+ * right after it; to overlap host updates with a launch, alternate two graphs.
+ * Barriers between nodes are placed the same way as in
+ * 'Sequence::record_dispatch()'.
+ *
+ * Example usage:
+ * ```cpp
+ * auto graph = engine.make_graph();
+ * const auto morton = graph->add_node(morton_algo, {div_ceil(n, 768), 1, 1});
+ * graph->add_node(sort_algo, {1, 1, 1});
+ *
+ * for (int frame = 0; frame < num_frames; ++frame) {
+ *   graph->update_buffer(morton, {engine.get_buffer_info(frames[frame]), ...});  // in place
+ *   graph->update_grid_size(morton, {div_ceil(counts[frame], 768), 1, 1});       // in place
+ *   graph->update_params(morton, MortonParams{.n = counts[frame]});              // in place
+ *   graph->launch_async();
+ *   graph->sync();
+ * }
+ * ```
+ */
+class Graph {
+ public:
+  /**
+   * @param mr_ptr Memory resource for the grid size buffer; its buffers need 'eIndirectBuffer'
+   * @param update_after_bind Whether the device supports update-after-bind storage buffers
+   */
+  explicit Graph(std::shared_ptr<Sequence> seq,
+                 VulkanMemoryResource* mr_ptr,
+                 PipelineRegistry* registry_ptr,
+                 bool update_after_bind);
+
+  ~Graph();
+
+  Graph(const Graph&) = delete;
+  Graph& operator=(const Graph&) = delete;
+
+  /**
+   * @brief Capture a dispatch with the Algorithm's current push constants and buffers
+   * @return Node index to use with the patching functions
+   */
+  size_t add_node(std::shared_ptr<Algorithm> algo, std::array<uint32_t, 3> grid_size);
+
+  /**
+   * @brief Capture a dispatch whose last binding is a parameter block owned by the Graph
+   *
+   * The kernel declares its per-launch values as a 'readonly buffer' at its last
+   * binding instead of push constants, and 'update_params()' patches them without
+   * recording again. Pass the Algorithm buffers for the other bindings, the last one
+   * (if given) is replaced by the node's slot. Blocks hold up to 'kMaxParamsSize' bytes.
+   *
+   * Example usage:
+   * ```cpp
+   * // shader: layout(std430, binding = 3) readonly buffer Params { uint n; } params;
+   * const auto add = graph->add_node(algo, {div_ceil(n, 256), 1, 1}, Params{.n = n});
+   * graph->update_params(add, Params{.n = n / 2});
+   * ```
+   */
+  size_t add_node(std::shared_ptr<Algorithm> algo,
+                  std::array<uint32_t, 3> grid_size,
+                  const void* params_ptr,
+                  size_t params_size);
+
+  template <typename T>
+  size_t add_node(std::shared_ptr<Algorithm> algo,
+                  const std::array<uint32_t, 3> grid_size,
+                  const T& params) {
+    return add_node(std::move(algo), grid_size, &params, sizeof(T));
+  }
+
+  // Patch a node, the change is picked up by the next 'launch_async()'
+  void update_push_constant(size_t node, const void* data_ptr, size_t size_in_bytes);
+
+  template <typename T>
+  void update_push_constant(const size_t node, const T& data) {
+    update_push_constant(node, &data, sizeof(T));
+  }
+
+  // In place, the node must have been added with a parameter block of this size
+  void update_params(size_t node, const void* data_ptr, size_t size_in_bytes);
+
+  template <typename T>
+  void update_params(const size_t node, const T& data) {
+    update_params(node, &data, sizeof(T));
+  }
+
+  void update_buffer(size_t node, std::initializer_list<vk::DescriptorBufferInfo> buffer_infos);
+  void update_grid_size(size_t node, std::array<uint32_t, 3> grid_size);
+
+  // Same semantics as 'Sequence::launch_kernel_async()'. On non-coherent memory, read
+  // buffers patched in place after 'sync()', the Future only covers the recorded ones.
+  Future launch_async(std::span<const Future> wait_on = {});
+  void sync();
+
+  [[nodiscard]] size_t num_nodes() const { return nodes_.size(); }
+
+  // How many times the command buffer was (re)recorded, useful to spot shape changes in hot loops
+  [[nodiscard]] size_t num_recordings() const { return num_recordings_; }
+
+  static constexpr size_t kMaxParamsSize = 128;
+
+ private:
+  // Aligned for any 'minStorageBufferOffsetAlignment', which the spec caps at 256
+  struct alignas(256) ParamsSlot {
+    std::array<std::byte, kMaxParamsSize> data;
+  };
+
+  struct Node {
+    std::shared_ptr<Algorithm> algo;
+    std::vector<std::byte> push_constants;
+    std::vector<vk::DescriptorBufferInfo> buffer_infos;
+    size_t params_size = 0;  // 0 without a parameter block
+
+    // Update-after-bind variant of the Algorithm's pipeline and the node's own set,
+    // null for bindless nodes and without device support
+    DispatchBinding binding;
+  };
+
+  void record();
+
+  // (Re)create one set per node in a fresh update-after-bind pool
+  void create_descriptor_sets();
+  void write_descriptor_set(const Node& node) const;
+
+  // Whether the node's buffers overlap the other nodes' buffers exactly as 'buffer_infos' would
+  [[nodiscard]] bool same_overlaps(size_t node,
+                                   std::span<const vk::DescriptorBufferInfo> buffer_infos) const;
+
+  [[nodiscard]] vk::DescriptorBufferInfo get_grid_size_info(size_t node) const;
+  [[nodiscard]] vk::DescriptorBufferInfo get_params_info(size_t node) const;
+
+  // Copy of 'buffer_infos' with the node's parameter block as the last binding
+  [[nodiscard]] std::vector<vk::DescriptorBufferInfo> with_params(
+      size_t node, std::span<const vk::DescriptorBufferInfo> buffer_infos) const;
+
+  // Buffers patched in place are not part of the Sequence's coherency ranges
+  void flush_buffers() const;
+  void invalidate_buffers() const;
+
+  std::shared_ptr<Sequence> seq_;
+  VulkanMemoryResource* mr_ptr_;
+  PipelineRegistry* registry_ptr_;
+  bool update_after_bind_;
+
+  std::vector<Node> nodes_;
+
+  // One work group count per node, read by the indirect dispatches
+  std::pmr::vector<vk::DispatchIndirectCommand> grid_sizes_;
+
+  // One parameter block per node, bound as a storage buffer
+  std::pmr::vector<ParamsSlot> params_;
+
+  vk::DescriptorPool descriptor_pool_ = nullptr;
+
+  // Still reads the patchable memory until it completes
+  Future last_launch_;
+
+  bool dirty_ = true;
+  size_t num_recordings_ = 0;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,64 @@
+#include "host_buffer.hpp"
+
+#include <cstring>
+
+namespace vulkan {
+
+namespace {
+
+// Matches what 'std::pmr::vector' asks for, the resource aligns further as needed
+constexpr size_t kCopyAlignment = alignof(std::max_align_t);
+
+}  // namespace
+
+HostBuffer::HostBuffer(VulkanMemoryResource* mr_ptr,
+                       void* ptr,
+                       const size_t bytes,
+                       const vk::DeviceSize offset_alignment)
+    : mr_ptr_(mr_ptr), original_(ptr), bytes_(bytes) {
+  if (!ptr || bytes == 0) {
+    throw std::runtime_error("HostBuffer needs a non-empty range");
+  }
+
+  if (mr_ptr_->supports_host_import()) {
+    try {
+      if (mr_ptr_->import_host_pointer(ptr, bytes).offset % offset_alignment == 0) {
+        zero_copy_ = true;
+        return;
+      }
+      mr_ptr_->release_host_pointer(ptr);
+      spdlog::debug("HostBuffer: pointer is not aligned for binding, copying {} bytes", bytes);
+    } catch (const std::exception& e) {
+      spdlog::debug("HostBuffer: import failed ({}), copying {} bytes", e.what(), bytes);
+    }
+  }
+
+  copy_ = mr_ptr_->allocate(bytes, kCopyAlignment);
+  std::memcpy(copy_, ptr, bytes);
+}
+
+HostBuffer::~HostBuffer() {
+  if (zero_copy_) {
+    mr_ptr_->release_host_pointer(original_);
+  } else {
+    mr_ptr_->deallocate(copy_, bytes_, kCopyAlignment);
+  }
+}
+
+vk::DescriptorBufferInfo HostBuffer::get_buffer_info() const {
+  const auto slice = mr_ptr_->get_buffer_slice(data());
+
+  return vk::DescriptorBufferInfo{
+      .buffer = slice.buffer,
+      .offset = slice.offset,
+      .range = bytes_,
+  };
+}
+
+void HostBuffer::write_back() const {
+  if (!zero_copy_) {
+    std::memcpy(original_, copy_, bytes_);
+  }
+}
+
+}  // namespace vulkan
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "vma_pmr.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// HostBuffer
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief GPU view of host memory the engine does not own (mmapped files, network buffers)
+ *
+ * Imports the memory zero-copy through VK_EXT_external_memory_host when the
+ * device supports it and accepts the pointer. Otherwise the range is copied
+ * into a USM allocation once, and 'data()' points to that copy; call
+ * 'write_back()' after the GPU wrote to it to update the original memory.
+ *
+ * Either way 'data()' is registered with the memory resource, so
+ * 'Engine::get_buffer_info(ptr, count)' works on it and on pointers into it.
+ *
+ * Example usage:
+ * ```cpp
+ * auto points = engine.import_host(mmapped_ptr, file_size);
+ * algo->update_buffer({points->get_buffer_info(), ...});
+ * ```
+ */
+class HostBuffer {
+ public:
+  // 'offset_alignment' is minStorageBufferOffsetAlignment; a pointer that would be bound
+  // at a misaligned offset is copied instead
+  HostBuffer(VulkanMemoryResource* mr_ptr,
+             void* ptr,
+             size_t bytes,
+             vk::DeviceSize offset_alignment);
+
+  ~HostBuffer();
+
+  HostBuffer(const HostBuffer&) = delete;
+  HostBuffer& operator=(const HostBuffer&) = delete;
+
+  // Pointer to bind and access, the original memory if imported
+  [[nodiscard]] void* data() const { return zero_copy_ ? original_ : copy_; }
+  [[nodiscard]] size_t size() const { return bytes_; }
+
+  [[nodiscard]] bool is_zero_copy() const { return zero_copy_; }
+
+  [[nodiscard]] vk::DescriptorBufferInfo get_buffer_info() const;
+
+  // Copy GPU results back into the original memory, no-op when imported
+  void write_back() const;
+
+ private:
+  VulkanMemoryResource* mr_ptr_;
+  void* original_;
+  void* copy_ = nullptr;
+  size_t bytes_;
+  bool zero_copy_ = false;
+};
+
+}  // namespace vulkan
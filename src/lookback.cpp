@@ -0,0 +1,13 @@
+#include "lookback.hpp"
+
+namespace vulkan {
+
+LookbackState::LookbackState(VulkanMemoryResource* mr_ptr) : words_(mr_ptr) {}
+
+vk::DescriptorBufferInfo LookbackState::record(Sequence& seq, const uint32_t num_tiles) {
+  const auto words = words_.get(seq, 1 + size_t{3} * num_tiles);
+  seq.record_fill(words.buffer, words.offset, words.range, 0);
+  return words;
+}
+
+}  // namespace vulkan
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "scratch_buffer.hpp"
+#include "sequence.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// LookbackState
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Status words of the decoupled look-back in 'lookback.glsl'
+ *
+ * A tile counter followed by (flag, aggregate, inclusive prefix) per tile,
+ * used by 'Scan' and 'Compact'. Every pass needs them zeroed, so 'record()'
+ * appends the fill before handing them out.
+ */
+class LookbackState {
+ public:
+  explicit LookbackState(VulkanMemoryResource* mr_ptr);
+
+  // Zeroed status words for a pass over 'num_tiles' tiles
+  [[nodiscard]] vk::DescriptorBufferInfo record(Sequence& seq, uint32_t num_tiles);
+
+ private:
+  ScratchBuffer words_;
+};
+
+}  // namespace vulkan
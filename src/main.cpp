@@ -1,10 +1,20 @@
 #include <spdlog/spdlog.h>
 
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <random>
+
 #include "engine.hpp"
+#include "tracer.hpp"
 
 template <typename T>
 using UsmVector = std::pmr::vector<T>;
 
+// Outcome of comparing a primitive's output against the std:: algorithm
+const char* verdict(const bool matches) { return matches ? "ok" : "MISMATCH"; }
+
 void run_hello_vector_add(vulkan::Engine& engine, vulkan::Sequence* seq) {
   constexpr auto n = 1024;
   UsmVector<float> input_a(n, engine.get_mr());
@@ -45,6 +55,53 @@ void run_hello_vector_add(vulkan::Engine& engine, vulkan::Sequence* seq) {
   }
 }
 
+void run_hello_vector_add_bindless(vulkan::Engine& engine, vulkan::Sequence* seq) {
+  constexpr auto n = 1024;
+  UsmVector<float> input_a(n, engine.get_mr());
+  UsmVector<float> input_b(n, engine.get_mr());
+  UsmVector<float> output(n, engine.get_mr());
+
+  std::ranges::fill(input_a, 1.0f);
+  std::ranges::fill(input_b, 2.0f);
+  std::ranges::fill(output, 0.0f);
+
+  struct Ps {
+    vk::DeviceAddress input_a;
+    vk::DeviceAddress input_b;
+    vk::DeviceAddress result;
+    uint32_t n;
+  };
+
+  // No descriptor bindings in the shader, so no 'num_buffers()'
+  auto algo = engine.make_algo("hello_vector_add_bindless")
+                  ->work_group_size(256, 1, 1)
+                  ->push_constant<Ps>()
+                  ->build();
+
+  algo->update_push_constant(Ps{
+      .input_a = engine.get_device_address(input_a.data()),
+      .input_b = engine.get_device_address(input_b.data()),
+      .result = engine.get_device_address(output.data()),
+      .n = n,
+  });
+
+  // Not bound, only tells the Sequence what the pointers reach
+  algo->update_buffer({
+      engine.get_buffer_info(input_a),
+      engine.get_buffer_info(input_b),
+      engine.get_buffer_info(output),
+  });
+
+  seq->record_commands(algo.get(), {vulkan::div_ceil(n, 256), 1, 1});
+  seq->launch_kernel_async();
+  seq->sync();
+
+  // print 10 output elements
+  for (auto i = 0; i < 10; i++) {
+    spdlog::info("output[{}] = {}", i, output[i]);
+  }
+}
+
 void run_multiple_steps(vulkan::Engine& engine, vulkan::Sequence* seq) {
   constexpr auto n = 1024;
   UsmVector<float> buf_a(n, engine.get_mr());
@@ -106,6 +163,478 @@ void run_multiple_steps(vulkan::Engine& engine, vulkan::Sequence* seq) {
   }
 }
 
+void run_staging(vulkan::Engine& engine, vulkan::Sequence* seq) {
+  // Larger than half the staging ring, so transfers are chunked
+  constexpr auto n = 12 << 20;
+  std::vector<float> host_a(n, 1.0f);
+  std::vector<float> host_b(n, 2.0f);
+  std::vector<float> host_output(n, 0.0f);
+
+  auto input_a = engine.make_device_buffer(n * sizeof(float));
+  auto input_b = engine.make_device_buffer(n * sizeof(float));
+  auto output = engine.make_device_buffer(n * sizeof(float));
+
+  engine.upload(*input_a, std::span<const float>(host_a));
+  engine.upload(*input_b, std::span<const float>(host_b));
+
+  struct Ps {
+    uint32_t n;
+  };
+
+  auto algo = engine.make_algo("hello_vector_add")->work_group_size(256, 1, 1)->build();
+
+  algo->update_push_constant(Ps{
+      .n = n,
+  });
+
+  algo->update_buffer({
+      input_a->get_buffer_info(),
+      input_b->get_buffer_info(),
+      output->get_buffer_info(),
+  });
+
+  seq->record_commands(algo.get(), {vulkan::div_ceil(n, 256), 1, 1});
+  seq->launch_kernel_async();
+  seq->sync();
+
+  engine.download(*output, std::span<float>(host_output));
+
+  const auto correct = std::ranges::count(host_output, 3.0f);
+  spdlog::info("StagingRing: {} of {} elements correct", correct, n);
+}
+
+void run_transient_pool(vulkan::Engine& engine, vulkan::Sequence* seq) {
+  constexpr auto n = 1024;
+  UsmVector<float> input_a(n, engine.get_mr());
+  UsmVector<float> input_b(n, engine.get_mr());
+  UsmVector<float> output(n, engine.get_mr());
+
+  std::ranges::fill(input_a, 1.0f);
+  std::ranges::fill(input_b, 2.0f);
+
+  struct Ps {
+    uint32_t n;
+  };
+
+  auto algo = engine.make_algo("hello_vector_add")->work_group_size(256, 1, 1)->build();
+
+  algo->update_push_constant(Ps{
+      .n = n,
+  });
+
+  // a + b -> t0 -> t1 -> t2 -> output, each step adds b again. 't2' may alias 't0'.
+  auto pool = engine.make_transient_pool();
+  const auto t0 = pool->declare(n * sizeof(float), 0, 1);
+  const auto t1 = pool->declare(n * sizeof(float), 1, 2);
+  const auto t2 = pool->declare(n * sizeof(float), 2, 3);
+  pool->plan();
+
+  const std::array<vk::DescriptorBufferInfo, 5> chain = {
+      engine.get_buffer_info(input_a),
+      pool->get_buffer_info(t0),
+      pool->get_buffer_info(t1),
+      pool->get_buffer_info(t2),
+      engine.get_buffer_info(output),
+  };
+
+  seq->cmd_begin();
+  for (size_t step = 0; step + 1 < chain.size(); ++step) {
+    algo->update_buffer({chain[step], engine.get_buffer_info(input_b), chain[step + 1]});
+    seq->record_dispatch(algo.get(), {vulkan::div_ceil(n, 256), 1, 1});
+  }
+  seq->cmd_end();
+  seq->launch_kernel_async();
+  seq->sync();
+
+  spdlog::info("TransientPool: {} bytes planned for {} declared, output[0] = {} (expected 9)",
+               pool->get_planned_bytes(),
+               pool->get_declared_bytes(),
+               output[0]);
+}
+
+void run_host_buffer(vulkan::Engine& engine, vulkan::Sequence* seq) {
+  constexpr auto n = 1024;
+  constexpr auto bytes = n * sizeof(float);
+
+  // Page-aligned host memory the engine does not own, as from mmap()
+  const auto host_alloc = [] {
+    return std::unique_ptr<float, decltype(&std::free)>(
+        static_cast<float*>(std::aligned_alloc(4096, bytes)), &std::free);
+  };
+  const auto host_a = host_alloc();
+  const auto host_b = host_alloc();
+  const auto host_output = host_alloc();
+
+  std::fill_n(host_a.get(), n, 1.0f);
+  std::fill_n(host_b.get(), n, 2.0f);
+  std::fill_n(host_output.get(), n, 0.0f);
+
+  const auto input_a = engine.import_host(host_a.get(), bytes);
+  const auto input_b = engine.import_host(host_b.get(), bytes);
+  const auto output = engine.import_host(host_output.get(), bytes);
+
+  struct Ps {
+    uint32_t n;
+  };
+
+  auto algo = engine.make_algo("hello_vector_add")->work_group_size(256, 1, 1)->build();
+
+  algo->update_push_constant(Ps{
+      .n = n,
+  });
+
+  algo->update_buffer({
+      input_a->get_buffer_info(),
+      input_b->get_buffer_info(),
+      output->get_buffer_info(),
+  });
+
+  seq->record_commands(algo.get(), {vulkan::div_ceil(n, 256), 1, 1});
+  seq->launch_kernel_async();
+  seq->sync();
+
+  // Copies back only if the import fell back to a copy
+  output->write_back();
+
+  spdlog::info("HostBuffer: zero-copy {}, output[0] = {} (expected 3)",
+               output->is_zero_copy(),
+               host_output.get()[0]);
+}
+
+void run_tracer(vulkan::Engine& engine) {
+  constexpr auto n = 1024;
+  UsmVector<float> input_a(n, engine.get_mr());
+  UsmVector<float> input_b(n, engine.get_mr());
+  UsmVector<float> output(n, engine.get_mr());
+
+  std::ranges::fill(input_a, 1.0f);
+  std::ranges::fill(input_b, 2.0f);
+
+  struct Ps {
+    uint32_t n;
+  };
+
+  auto& tracer = vulkan::Tracer::instance();
+  tracer.enable();
+
+  // Host spans from the engine, GPU spans from the profiled Sequence
+  auto seq = engine.make_profiled_seq();
+  auto algo = engine.make_algo("hello_vector_add")->work_group_size(256, 1, 1)->build();
+
+  algo->update_push_constant(Ps{
+      .n = n,
+  });
+
+  algo->update_buffer({
+      engine.get_buffer_info(input_a),
+      engine.get_buffer_info(input_b),
+      engine.get_buffer_info(output),
+  });
+
+  for (auto i = 0; i < 3; i++) {
+    seq->record_commands(algo.get(), {vulkan::div_ceil(n, 256), 1, 1});
+    seq->launch_kernel_async();
+    seq->sync();
+  }
+
+  for (const auto& timing : seq->get_timings()) {
+    spdlog::info("Tracer: [{}] took {:.3f} ms", timing.shader_name, timing.duration_ms());
+  }
+
+  tracer.write_chrome_trace("trace.json");
+  tracer.disable();
+}
+
+void run_graph(vulkan::Engine& engine) {
+  constexpr auto n = 1024;
+  UsmVector<float> input_a(n, engine.get_mr());
+  UsmVector<float> input_b(n, engine.get_mr());
+  UsmVector<float> output_a(n, engine.get_mr());
+  UsmVector<float> output_b(n, engine.get_mr());
+
+  std::ranges::fill(input_a, 1.0f);
+  std::ranges::fill(input_b, 2.0f);
+
+  // Read from the node's parameter block, not from push constants
+  struct Params {
+    uint32_t n;
+  };
+
+  auto algo = engine.make_algo("hello_vector_add_params")->work_group_size(256, 1, 1)->build();
+
+  auto graph = engine.make_graph();
+  const auto node = graph->add_node(algo, {vulkan::div_ceil(n, 256), 1, 1}, Params{.n = n});
+  graph->update_buffer(node,
+                       {
+                           engine.get_buffer_info(input_a),
+                           engine.get_buffer_info(input_b),
+                           engine.get_buffer_info(output_a),
+                       });
+
+  // Each launch patches the count, the output and the grid size in place
+  for (uint32_t count = n; count >= n / 4; count /= 2) {
+    auto& output = count == n / 2 ? output_b : output_a;
+    std::ranges::fill(output, 0.0f);
+
+    graph->update_params(node, Params{.n = count});
+    graph->update_buffer(node,
+                         {
+                             engine.get_buffer_info(input_a),
+                             engine.get_buffer_info(input_b),
+                             engine.get_buffer_info(output),
+                         });
+    graph->update_grid_size(node, {static_cast<uint32_t>(vulkan::div_ceil(count, 256)), 1, 1});
+    graph->launch_async();
+    graph->sync();
+
+    const auto written = std::ranges::count(output, 3.0f);
+    spdlog::info("Graph: count {}, {} elements written", count, written);
+  }
+
+  spdlog::info("Graph: {} recording(s) for 3 launches", graph->num_recordings());
+}
+
+void run_scan(vulkan::Engine& engine, vulkan::Sequence* seq) {
+  // Over a thousand tiles, so the look-back crosses many subgroup-wide windows
+  constexpr uint32_t n = (1u << 20) + 123;
+  UsmVector<uint32_t> input(n, engine.get_mr());
+  UsmVector<uint32_t> inclusive(n, engine.get_mr());
+  UsmVector<uint32_t> exclusive(n, engine.get_mr());
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<uint32_t> dist(0, 15);
+  std::ranges::generate(input, [&] { return dist(gen); });
+
+  // Both scans share one submission, the Sequence orders them
+  auto scan = engine.make_scan(vulkan::ElementType::kUint);
+  seq->cmd_begin();
+  scan->record(*seq,
+               engine.get_buffer_info(input),
+               engine.get_buffer_info(inclusive),
+               n,
+               vulkan::ScanMode::kInclusive);
+  scan->record(*seq,
+               engine.get_buffer_info(input),
+               engine.get_buffer_info(exclusive),
+               n,
+               vulkan::ScanMode::kExclusive);
+  seq->cmd_end();
+  seq->launch_kernel_async();
+  seq->sync();
+
+  std::vector<uint32_t> expected(n);
+  std::inclusive_scan(input.begin(), input.end(), expected.begin());
+  const auto inclusive_ok = std::ranges::equal(inclusive, expected);
+  std::exclusive_scan(input.begin(), input.end(), expected.begin(), 0u);
+  const auto exclusive_ok = std::ranges::equal(exclusive, expected);
+
+  spdlog::info("Scan: {} elements, inclusive {}, exclusive {}",
+               n,
+               verdict(inclusive_ok),
+               verdict(exclusive_ok));
+}
+
+void run_radix_sort(vulkan::Engine& engine, vulkan::Sequence* seq) {
+  // Hundreds of tiles, so every pass scans digit counts across many of them
+  constexpr uint32_t n = 300'000;
+  std::mt19937_64 gen(42);
+
+  // Keys only, full 32-bit range so no pass is skipped
+  UsmVector<uint32_t> keys(n, engine.get_mr());
+  std::ranges::generate(keys, [&] { return static_cast<uint32_t>(gen()); });
+  std::vector<uint32_t> expected_keys(keys.begin(), keys.end());
+  std::ranges::stable_sort(expected_keys);
+
+  // 64-bit keys with many duplicates, the values record the input order to check stability
+  UsmVector<uint64_t> pair_keys(n, engine.get_mr());
+  UsmVector<uint32_t> values(n, engine.get_mr());
+  std::ranges::generate(pair_keys, [&] { return (gen() % 1000) << 40; });
+  std::iota(values.begin(), values.end(), 0u);
+
+  std::vector<std::pair<uint64_t, uint32_t>> expected_pairs;
+  expected_pairs.reserve(n);
+  for (uint32_t i = 0; i < n; ++i) {
+    expected_pairs.emplace_back(pair_keys[i], values[i]);
+  }
+  std::ranges::stable_sort(expected_pairs, {}, &std::pair<uint64_t, uint32_t>::first);
+
+  auto key_sort = engine.make_radix_sort(32);
+  auto pair_sort = engine.make_key_value_sort<uint64_t, uint32_t>();
+
+  seq->cmd_begin();
+  key_sort->record(*seq, engine.get_buffer_info(keys), n);
+  pair_sort->record(*seq, engine.get_buffer_info(pair_keys), n, engine.get_buffer_info(values));
+  seq->cmd_end();
+  seq->launch_kernel_async();
+  seq->sync();
+
+  auto pairs_ok = true;
+  for (uint32_t i = 0; i < n; ++i) {
+    pairs_ok &= pair_keys[i] == expected_pairs[i].first && values[i] == expected_pairs[i].second;
+  }
+
+  spdlog::info("RadixSort: {} keys {}, key-value {}",
+               n,
+               verdict(std::ranges::equal(keys, expected_keys)),
+               verdict(pairs_ok));
+}
+
+void run_gather(vulkan::Engine& engine, vulkan::Sequence* seq) {
+  constexpr uint32_t n = 300'000;
+  std::mt19937 gen(42);
+
+  // Per-point attributes follow the permutation that sorts the Morton codes
+  struct Attributes {
+    float x, y, z;
+    uint32_t rgba;
+  };
+
+  UsmVector<uint32_t> morton_codes(n, engine.get_mr());
+  UsmVector<uint32_t> order(n, engine.get_mr());
+  UsmVector<Attributes> attributes(n, engine.get_mr());
+  UsmVector<Attributes> sorted_attributes(n, engine.get_mr());
+
+  std::ranges::generate(morton_codes, [&] { return static_cast<uint32_t>(gen() % (n / 4)); });
+  for (uint32_t i = 0; i < n; ++i) {
+    const auto f = static_cast<float>(i);
+    attributes[i] = Attributes{.x = f, .y = 2.0f * f, .z = -f, .rgba = i};
+  }
+
+  std::vector<uint32_t> expected_order(n);
+  std::iota(expected_order.begin(), expected_order.end(), 0u);
+  std::ranges::stable_sort(expected_order, {}, [&](const uint32_t i) { return morton_codes[i]; });
+
+  auto sort = engine.make_key_value_sort<uint32_t, uint32_t>();
+  auto gather = engine.make_gather<Attributes>();
+
+  seq->cmd_begin();
+  sort->record_argsort(
+      *seq, engine.get_buffer_info(morton_codes), n, engine.get_buffer_info(order));
+  gather->record(*seq,
+                 engine.get_buffer_info(order),
+                 engine.get_buffer_info(attributes),
+                 engine.get_buffer_info(sorted_attributes),
+                 n);
+  seq->cmd_end();
+  seq->launch_kernel_async();
+  seq->sync();
+
+  auto gathered_ok = true;
+  for (uint32_t i = 0; i < n; ++i) {
+    const auto& expected = attributes[expected_order[i]];
+    const auto& actual = sorted_attributes[i];
+    gathered_ok &= actual.x == expected.x && actual.y == expected.y && actual.z == expected.z &&
+                   actual.rgba == expected.rgba;
+  }
+
+  spdlog::info("Gather: {} points, argsort {}, gathered attributes {}",
+               n,
+               verdict(std::ranges::equal(order, expected_order)),
+               verdict(gathered_ok));
+}
+
+void run_merge_sort(vulkan::Engine& engine, vulkan::Sequence* seq) {
+  // About a hundred tiles, so the merge passes run until runs of n / 2 are merged
+  constexpr uint32_t n = 100'000;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int32_t> dist(-500, 500);
+
+  for (const bool descending : {false, true}) {
+    // Float keys only, and signed keys with their input position as the value
+    UsmVector<float> keys(n, engine.get_mr());
+    UsmVector<int32_t> pair_keys(n, engine.get_mr());
+    UsmVector<uint32_t> values(n, engine.get_mr());
+    std::ranges::generate(keys, [&] { return static_cast<float>(dist(gen)) * 0.25f; });
+    std::ranges::generate(pair_keys, [&] { return dist(gen); });
+    std::iota(values.begin(), values.end(), 0u);
+
+    std::vector<float> expected_keys(keys.begin(), keys.end());
+    std::vector<uint32_t> expected_values(values.begin(), values.end());
+    const auto key_of = [&](const uint32_t i) { return pair_keys[i]; };
+    if (descending) {
+      std::ranges::stable_sort(expected_keys, std::greater{});
+      std::ranges::stable_sort(expected_values, std::greater{}, key_of);
+    } else {
+      std::ranges::stable_sort(expected_keys);
+      std::ranges::stable_sort(expected_values, {}, key_of);
+    }
+
+    auto key_sort = engine.make_merge_sort(vulkan::SortKeyType::kFloat32, 0, descending);
+    auto pair_sort =
+        engine.make_merge_sort(vulkan::SortKeyType::kInt32, sizeof(uint32_t), descending);
+
+    seq->cmd_begin();
+    key_sort->record(*seq, engine.get_buffer_info(keys), n);
+    pair_sort->record(*seq, engine.get_buffer_info(pair_keys), n, engine.get_buffer_info(values));
+    seq->cmd_end();
+    seq->launch_kernel_async();
+    seq->sync();
+
+    // Equal values imply equal keys, the values were the input positions
+    spdlog::info("MergeSort: {} {} keys {}, key-value {}",
+                 n,
+                 descending ? "descending" : "ascending",
+                 verdict(std::ranges::equal(keys, expected_keys)),
+                 verdict(std::ranges::equal(values, expected_values)));
+  }
+}
+
+void run_compact(vulkan::Engine& engine, vulkan::Sequence* seq) {
+  // Over a thousand tiles, so the look-back crosses many subgroup-wide windows
+  constexpr uint32_t n = (1u << 20) + 123;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<uint32_t> dist(0, 3);
+
+  // Runs of equal values for unique, flags of a predicate for copy_if
+  const auto is_kept = [](const uint32_t v) { return v % 3 == 0; };
+  UsmVector<uint32_t> input(n, engine.get_mr());
+  UsmVector<uint32_t> flags(n, engine.get_mr());
+  uint32_t value = 0;
+  std::ranges::generate(input, [&] { return value += dist(gen) == 0 ? 1u : 0u; });
+  std::ranges::transform(input, flags.begin(), [&](const uint32_t v) { return is_kept(v); });
+
+  UsmVector<uint32_t> flagged(n, engine.get_mr());
+  UsmVector<uint32_t> unique(n, engine.get_mr());
+  UsmVector<uint32_t> flagged_count(1, engine.get_mr());
+  UsmVector<uint32_t> unique_count(1, engine.get_mr());
+
+  auto copy_if = engine.make_compact<uint32_t>(vulkan::CompactMode::kFlagged);
+  auto make_unique = engine.make_compact<uint32_t>(vulkan::CompactMode::kUnique);
+
+  seq->cmd_begin();
+  copy_if->record(*seq,
+                  engine.get_buffer_info(input),
+                  engine.get_buffer_info(flagged),
+                  engine.get_buffer_info(flagged_count),
+                  n,
+                  engine.get_buffer_info(flags));
+  make_unique->record(*seq,
+                      engine.get_buffer_info(input),
+                      engine.get_buffer_info(unique),
+                      engine.get_buffer_info(unique_count),
+                      n);
+  seq->cmd_end();
+  seq->launch_kernel_async().wait();
+
+  std::vector<uint32_t> expected_flagged;
+  std::ranges::copy_if(input, std::back_inserter(expected_flagged), is_kept);
+
+  std::vector<uint32_t> expected_unique(input.begin(), input.end());
+  expected_unique.erase(std::unique(expected_unique.begin(), expected_unique.end()),
+                        expected_unique.end());
+
+  // The outputs have room for all n elements, only the first 'count' are written
+  flagged.resize(flagged_count[0]);
+  unique.resize(unique_count[0]);
+
+  spdlog::info("Compact: {} elements, copy_if kept {} {}, unique kept {} {}",
+               n,
+               flagged.size(),
+               verdict(std::ranges::equal(flagged, expected_flagged)),
+               unique.size(),
+               verdict(std::ranges::equal(unique, expected_unique)));
+}
+
 int main() {
   spdlog::set_level(spdlog::level::trace);
 
@@ -114,8 +643,30 @@ int main() {
 
   run_hello_vector_add(engine, seq.get());
 
+  run_hello_vector_add_bindless(engine, seq.get());
+
   run_multiple_steps(engine, seq.get());
 
+  run_staging(engine, seq.get());
+
+  run_transient_pool(engine, seq.get());
+
+  run_host_buffer(engine, seq.get());
+
+  run_tracer(engine);
+
+  run_graph(engine);
+
+  run_scan(engine, seq.get());
+
+  run_radix_sort(engine, seq.get());
+
+  run_gather(engine, seq.get());
+
+  run_merge_sort(engine, seq.get());
+
+  run_compact(engine, seq.get());
+
   spdlog::info("done!");
   return 0;
 }
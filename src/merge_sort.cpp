@@ -0,0 +1,111 @@
+#include "merge_sort.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "tracer.hpp"
+
+namespace vulkan {
+
+MergeSort::MergeSort(Kernels kernels,
+                     VulkanMemoryResource* mr_ptr,
+                     const SortKeyType key_type,
+                     const uint32_t value_bytes)
+    : kernels_(std::move(kernels)),
+      key_type_(key_type),
+      key_words_(key_type == SortKeyType::kUint64 ? 2 : 1),
+      value_words_(value_bytes / 4),
+      keys_alt_(mr_ptr),
+      values_alt_(mr_ptr),
+      partitions_(mr_ptr) {
+  if (value_bytes % 4 != 0) {
+    throw std::runtime_error("MergeSort value size must be a multiple of 4 bytes, got " +
+                             std::to_string(value_bytes));
+  }
+}
+
+void MergeSort::reserve(const uint32_t n) {
+  keys_alt_.reserve(size_t{n} * key_words_);
+  values_alt_.reserve(size_t{n} * value_words_);
+  partitions_.reserve(div_ceil(n, kTileSize) + 1);
+}
+
+void MergeSort::record(Sequence& seq,
+                       const vk::DescriptorBufferInfo& keys,
+                       const uint32_t n,
+                       const std::optional<vk::DescriptorBufferInfo>& values) {
+  spdlog::trace("MergeSort::record() n: {}", n);
+  const ScopedTrace trace("MergeSort::record");
+
+  if (values.has_value() != (value_words_ > 0)) {
+    throw std::runtime_error(value_words_ > 0 ? "MergeSort was made for key-value pairs"
+                                              : "MergeSort was made for keys only");
+  }
+
+  if (n <= 1) {
+    return;
+  }
+
+  const auto num_tiles = static_cast<uint32_t>(div_ceil(n, kTileSize));
+  const std::array<uint32_t, 3> grid_size{std::min(num_tiles, kMaxWorkGroupCount), 1, 1};
+
+  const auto partitions = partitions_.get(seq, size_t{num_tiles} + 1);
+
+  auto src_keys = keys;
+  auto dst_keys = keys_alt_.get(seq, size_t{n} * key_words_);
+  auto [src_values, dst_values] =
+      get_sort_values(seq, values, values_alt_, size_t{n} * value_words_, src_keys, dst_keys);
+
+  // Sorted runs of kTileSize
+  kernels_.block_sort->update_push_constant(n);
+  kernels_.block_sort->update_buffer({src_keys, dst_keys, src_values, dst_values});
+  seq.record_dispatch(kernels_.block_sort.get(), grid_size);
+
+  // Runs double in every pass, the partition kernel has one thread per tile boundary
+  const auto num_partition_groups = std::min(
+      static_cast<uint32_t>(div_ceil(size_t{num_tiles} + 1, kWorkGroupSize)), kMaxWorkGroupCount);
+  for (uint32_t width = kTileSize; width < n; width *= 2) {
+    std::swap(src_keys, dst_keys);
+    std::swap(src_values, dst_values);
+
+    const PushConstants pc{
+        .num_elements = n,
+        .width = width,
+        .tile_size = kTileSize,
+        .num_tiles = num_tiles,
+    };
+
+    kernels_.partition->update_push_constant(pc);
+    kernels_.partition->update_buffer({src_keys, partitions});
+    seq.record_dispatch(kernels_.partition.get(), {num_partition_groups, 1, 1});
+
+    kernels_.merge->update_push_constant(pc);
+    kernels_.merge->update_buffer({src_keys, dst_keys, src_values, dst_values, partitions});
+    seq.record_dispatch(kernels_.merge.get(), grid_size);
+  }
+
+  // Even number of merge passes, the result is in the temporaries
+  if (dst_keys.buffer != keys.buffer || dst_keys.offset != keys.offset) {
+    seq.record_copy(dst_keys.buffer,
+                    keys.buffer,
+                    vk::BufferCopy{
+                        .srcOffset = dst_keys.offset,
+                        .dstOffset = keys.offset,
+                        .size = size_t{n} * key_words_ * sizeof(uint32_t),
+                    });
+    if (value_words_ > 0) {
+      seq.record_copy(dst_values.buffer,
+                      values->buffer,
+                      vk::BufferCopy{
+                          .srcOffset = dst_values.offset,
+                          .dstOffset = values->offset,
+                          .size = size_t{n} * value_words_ * sizeof(uint32_t),
+                      });
+    }
+  }
+}
+
+}  // namespace vulkan
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include "algorithm.hpp"
+#include "scratch_buffer.hpp"
+#include "sequence.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// MergeSort
+// ----------------------------------------------------------------------------
+
+enum class SortKeyType {
+  kUint32,
+  kInt32,
+  kFloat32,
+  kUint64,
+};
+
+/**
+ * @brief Device-wide stable comparison sort
+ *
+ * For keys 'RadixSort' can't order by their bits: signed integers, floats
+ * (NaNs excluded), descending orders and 64-bit composite keys.
+ *   1. each tile of kTileSize keys is sorted in shared memory ('prim_merge_block_sort')
+ *   2. sorted runs are merged pairwise until one remains; per pass, a merge-path
+ *      search splits the output into equal tiles ('prim_merge_partition') and
+ *      work groups merge them one tile at a time ('prim_merge_pass')
+ *
+ * Every pass keeps all work groups busy, even the last one merging two runs
+ * of n / 2. Past 'kMaxWorkGroupCount' tiles, each work group takes several
+ * in turn. All passes are appended to the same recording; the host never
+ * waits in between. Keys ping-pong through a temporary buffer and end up back
+ * in the input.
+ *
+ * Example usage:
+ * ```cpp
+ * auto sort = engine.make_merge_sort(SortKeyType::kFloat32, sizeof(uint32_t));
+ * seq->cmd_begin();
+ * sort->record(*seq, engine.get_buffer_info(depths), n, engine.get_buffer_info(indices));
+ * seq->cmd_end();
+ * seq->launch_kernel_async();
+ * seq->sync();
+ * ```
+ */
+class MergeSort {
+ public:
+  static constexpr uint32_t kWorkGroupSize = 256;
+  static constexpr uint32_t kTileSize = kWorkGroupSize * 4;
+
+  // Built 'prim_merge_*' Algorithms, see 'Engine::make_merge_sort()'
+  struct Kernels {
+    std::shared_ptr<Algorithm> block_sort;
+    std::shared_ptr<Algorithm> partition;
+    std::shared_ptr<Algorithm> merge;
+  };
+
+  /**
+   * @param value_bytes Size of the value moved with each key, a multiple of 4; 0 for keys only
+   */
+  explicit MergeSort(Kernels kernels,
+                     VulkanMemoryResource* mr_ptr,
+                     SortKeyType key_type,
+                     uint32_t value_bytes = 0);
+
+  MergeSort(const MergeSort&) = delete;
+  MergeSort& operator=(const MergeSort&) = delete;
+
+  /**
+   * @brief Append a sort of 'n' keys (and values) to the recording of 'seq'
+   * @param keys 'n' keys, sorted in place
+   * @param values 'n' values, required if and only if the sort was made with a value size
+   */
+  void record(Sequence& seq,
+              const vk::DescriptorBufferInfo& keys,
+              uint32_t n,
+              const std::optional<vk::DescriptorBufferInfo>& values = std::nullopt);
+
+  // Allocate the temporaries for up to 'n' keys up front
+  void reserve(uint32_t n);
+
+  [[nodiscard]] SortKeyType get_key_type() const { return key_type_; }
+  [[nodiscard]] uint32_t get_value_bytes() const { return value_words_ * 4; }
+
+ private:
+  struct PushConstants {
+    uint32_t num_elements;
+    uint32_t width;
+    uint32_t tile_size;
+    uint32_t num_tiles;
+  };
+
+  Kernels kernels_;
+  SortKeyType key_type_;
+  uint32_t key_words_;
+  uint32_t value_words_;
+
+  // Ping-pong keys and values, and the merge path split of every tile boundary
+  ScratchBuffer keys_alt_;
+  ScratchBuffer values_alt_;
+  ScratchBuffer partitions_;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,152 @@
+#include "pipeline_cache.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace vulkan {
+
+namespace {
+
+// "KVPC" (kiss-vk pipeline cache)
+constexpr uint32_t kPipelineCacheMagic = 0x4350564b;
+constexpr uint32_t kPipelineCacheHeaderVersion = 1;
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+// Constructor / Destructor
+// ----------------------------------------------------------------------------
+
+PipelineCache::PipelineCache(const vk::Device device,
+                             const vk::PhysicalDevice& physical_device,
+                             std::string file_path)
+    : device_ref_(device),
+      device_properties_(physical_device.getProperties()),
+      file_path_(std::move(file_path)) {
+  const auto initial_data = load_from_file();
+
+  const vk::PipelineCacheCreateInfo create_info{
+      .initialDataSize = initial_data.size(),
+      .pInitialData = initial_data.empty() ? nullptr : initial_data.data(),
+  };
+
+  handle_ = device_ref_.createPipelineCache(create_info);
+
+  spdlog::debug("Pipeline cache created with {} bytes of initial data", initial_data.size());
+}
+
+PipelineCache::~PipelineCache() {
+  if (!handle_) {
+    return;
+  }
+
+  try {
+    save();
+  } catch (const std::exception& e) {
+    spdlog::warn("Failed to save pipeline cache: {}", e.what());
+  }
+
+  device_ref_.destroyPipelineCache(handle_);
+}
+
+// ----------------------------------------------------------------------------
+// Header
+// ----------------------------------------------------------------------------
+
+PipelineCache::FileHeader PipelineCache::make_header(const uint64_t data_size) const {
+  FileHeader header{
+      .magic = kPipelineCacheMagic,
+      .header_version = kPipelineCacheHeaderVersion,
+      .vendor_id = device_properties_.vendorID,
+      .device_id = device_properties_.deviceID,
+      .driver_version = device_properties_.driverVersion,
+      .pipeline_cache_uuid = {},
+      .reserved = 0,
+      .data_size = data_size,
+  };
+
+  std::memcpy(
+      header.pipeline_cache_uuid, device_properties_.pipelineCacheUUID.data(), VK_UUID_SIZE);
+
+  return header;
+}
+
+// ----------------------------------------------------------------------------
+// Load / Save
+// ----------------------------------------------------------------------------
+
+std::vector<uint8_t> PipelineCache::load_from_file() const {
+  if (file_path_.empty()) {
+    return {};
+  }
+
+  std::ifstream file(file_path_, std::ios::binary);
+  if (!file) {
+    spdlog::debug("No pipeline cache found at '{}', starting cold", file_path_);
+    return {};
+  }
+
+  FileHeader header{};
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    spdlog::warn("Pipeline cache '{}' is truncated, ignoring it", file_path_);
+    return {};
+  }
+
+  const auto expected = make_header(header.data_size);
+  if (std::memcmp(&header, &expected, sizeof(FileHeader)) != 0) {
+    spdlog::info("Pipeline cache '{}' was built for another device or driver, ignoring it",
+                 file_path_);
+    return {};
+  }
+
+  // The payload must fill the rest of the file exactly, a corrupt size is never allocated
+  std::error_code ec;
+  const auto file_size = std::filesystem::file_size(file_path_, ec);
+  if (ec || file_size - sizeof(FileHeader) != header.data_size) {
+    spdlog::warn("Pipeline cache '{}' has an inconsistent size, ignoring it", file_path_);
+    return {};
+  }
+
+  std::vector<uint8_t> data(header.data_size);
+  if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+    spdlog::warn("Pipeline cache '{}' is truncated, ignoring it", file_path_);
+    return {};
+  }
+
+  return data;
+}
+
+void PipelineCache::save() const {
+  if (file_path_.empty()) {
+    return;
+  }
+
+  const auto data = device_ref_.getPipelineCacheData(handle_);
+  const auto header = make_header(data.size());
+
+  // Write to a temporary file first so a crash never leaves a corrupted cache behind
+  const auto tmp_path = file_path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      throw std::runtime_error("Failed to open " + tmp_path + " for writing");
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.data()),
+               static_cast<std::streamsize>(data.size()));
+
+    if (!file) {
+      throw std::runtime_error("Failed to write " + tmp_path);
+    }
+  }
+
+  std::filesystem::rename(tmp_path, file_path_);
+
+  spdlog::debug("Pipeline cache saved to '{}' ({} bytes)", file_path_, data.size());
+}
+
+}  // namespace vulkan
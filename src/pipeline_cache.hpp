@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "vk.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// PipelineCache
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Engine-owned 'vk::PipelineCache' persisted to disk between runs
+ *
+ * The cache blob is loaded at construction and written back on destruction.
+ * The file is prefixed with a small header (vendor/device id, driver version
+ * and pipeline cache UUID). If any of them does not match the current device,
+ * the file is ignored and an empty cache is created instead.
+ *
+ * An empty 'file_path' disables persistence; the cache is then only shared
+ * in memory for the lifetime of the engine.
+ */
+class PipelineCache {
+ public:
+  explicit PipelineCache(vk::Device device,
+                         const vk::PhysicalDevice& physical_device,
+                         std::string file_path);
+
+  ~PipelineCache();
+
+  PipelineCache(const PipelineCache&) = delete;
+  PipelineCache& operator=(const PipelineCache&) = delete;
+
+  [[nodiscard]] vk::PipelineCache get_handle() const { return handle_; }
+
+  // Serialize the current cache content to 'file_path_'
+  void save() const;
+
+ private:
+  struct FileHeader {
+    uint32_t magic;
+    uint32_t header_version;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t pipeline_cache_uuid[VK_UUID_SIZE];
+    uint32_t reserved;  // keeps 'data_size' 8-byte aligned without implicit padding
+    uint64_t data_size;
+  };
+  static_assert(sizeof(FileHeader) == 48, "FileHeader must not contain padding");
+
+  [[nodiscard]] FileHeader make_header(uint64_t data_size) const;
+  [[nodiscard]] std::vector<uint8_t> load_from_file() const;
+
+  vk::Device device_ref_;
+  vk::PhysicalDeviceProperties device_properties_;
+  std::string file_path_;
+
+  vk::PipelineCache handle_ = nullptr;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,368 @@
+#include "pipeline_registry.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+#include <functional>
+
+#include "shaders/all_shaders.hpp"
+
+namespace vulkan {
+
+namespace {
+
+void hash_combine(size_t& seed, const size_t value) {
+  seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+}  // namespace
+
+size_t PipelineKeyHash::operator()(const PipelineKey& key) const noexcept {
+  size_t seed = std::hash<std::string>{}(key.shader_name);
+  hash_combine(seed, key.num_buffers);
+  hash_combine(seed, key.push_constant_size);
+  for (const auto v : key.work_group_size) {
+    hash_combine(seed, v);
+  }
+  for (const auto v : key.specialization_data) {
+    hash_combine(seed, v);
+  }
+  hash_combine(seed, key.required_subgroup_size);
+  hash_combine(seed, key.update_after_bind);
+  return seed;
+}
+
+// ----------------------------------------------------------------------------
+// Constructor / Destructor
+// ----------------------------------------------------------------------------
+
+PipelineRegistry::PipelineRegistry(const vk::Device device,
+                                   const vk::PipelineCache pipeline_cache,
+                                   const bool subgroup_size_control,
+                                   const bool push_descriptors)
+    : device_ref_(device),
+      pipeline_cache_ref_(pipeline_cache),
+      subgroup_size_control_(subgroup_size_control),
+      push_descriptors_(push_descriptors) {}
+
+PipelineRegistry::~PipelineRegistry() {
+  spdlog::debug("PipelineRegistry destroyed ({} pipelines, {} shader modules)",
+                pipelines_.size(),
+                shader_entries_.size());
+
+  for (const auto& [_, pipeline] : pipelines_) {
+    device_ref_.destroyPipeline(pipeline);
+  }
+  for (const auto& [_, update_template] : update_templates_) {
+    device_ref_.destroyDescriptorUpdateTemplate(update_template);
+  }
+  for (const auto& [_, pipeline_layout] : pipeline_layouts_) {
+    device_ref_.destroyPipelineLayout(pipeline_layout);
+  }
+  for (const auto& [_, set_layout] : descriptor_set_layouts_) {
+    device_ref_.destroyDescriptorSetLayout(set_layout);
+  }
+  for (const auto& [_, entry] : shader_entries_) {
+    device_ref_.destroyShaderModule(entry.shader_module);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Public getters
+// ----------------------------------------------------------------------------
+
+vk::ShaderModule PipelineRegistry::get_shader_module(const std::string& shader_name) {
+  std::lock_guard lock(mutex_);
+  return shader_entry_locked(shader_name).shader_module;
+}
+
+const ShaderReflection& PipelineRegistry::get_reflection(const std::string& shader_name) {
+  std::lock_guard lock(mutex_);
+  return shader_entry_locked(shader_name).reflection;
+}
+
+vk::DescriptorSetLayout PipelineRegistry::get_descriptor_set_layout(const size_t num_buffers,
+                                                                    const bool update_after_bind) {
+  std::lock_guard lock(mutex_);
+  return descriptor_set_layout_locked(num_buffers, update_after_bind);
+}
+
+vk::PipelineLayout PipelineRegistry::get_pipeline_layout(const size_t num_buffers,
+                                                         const size_t push_constant_size,
+                                                         const bool update_after_bind) {
+  std::lock_guard lock(mutex_);
+  return pipeline_layout_locked(num_buffers, push_constant_size, update_after_bind);
+}
+
+vk::Pipeline PipelineRegistry::get_pipeline(const PipelineKey& key) {
+  std::lock_guard lock(mutex_);
+
+  if (const auto it = pipelines_.find(key); it != pipelines_.end()) {
+    spdlog::trace("PipelineRegistry: reusing pipeline [{}]", key.shader_name);
+    return it->second;
+  }
+
+  const auto shader_module = shader_entry_locked(key.shader_name).shader_module;
+  const auto pipeline_layout =
+      pipeline_layout_locked(key.num_buffers, key.push_constant_size, key.update_after_bind);
+  const auto pipeline = create_pipeline(shader_module, pipeline_layout, key);
+
+  pipelines_.emplace(key, pipeline);
+  return pipeline;
+}
+
+vk::DescriptorUpdateTemplate PipelineRegistry::get_update_template(const size_t num_buffers) {
+  std::lock_guard lock(mutex_);
+
+  if (const auto it = update_templates_.find(num_buffers); it != update_templates_.end()) {
+    return it->second;
+  }
+
+  std::vector<vk::DescriptorUpdateTemplateEntry> entries;
+  entries.reserve(num_buffers);
+
+  for (uint32_t i = 0; i < num_buffers; ++i) {
+    entries.emplace_back(vk::DescriptorUpdateTemplateEntry{
+        .dstBinding = i,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .offset = i * sizeof(vk::DescriptorBufferInfo),
+        .stride = sizeof(vk::DescriptorBufferInfo),
+    });
+  }
+
+  const vk::DescriptorUpdateTemplateCreateInfo create_info{
+      .descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size()),
+      .pDescriptorUpdateEntries = entries.data(),
+      .templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet,
+      .descriptorSetLayout = descriptor_set_layout_locked(num_buffers, false),
+  };
+
+  const auto update_template = device_ref_.createDescriptorUpdateTemplate(create_info);
+  update_templates_.emplace(num_buffers, update_template);
+  return update_template;
+}
+
+// ----------------------------------------------------------------------------
+// Interning (mutex_ held)
+// ----------------------------------------------------------------------------
+
+const PipelineRegistry::ShaderEntry& PipelineRegistry::shader_entry_locked(
+    const std::string& shader_name) {
+  if (const auto it = shader_entries_.find(shader_name); it != shader_entries_.end()) {
+    return it->second;
+  }
+
+  // unordered_map never moves its nodes, so the returned reference stays valid
+  return shader_entries_.emplace(shader_name, create_shader_entry(shader_name)).first->second;
+}
+
+vk::DescriptorSetLayout PipelineRegistry::descriptor_set_layout_locked(
+    const size_t num_buffers, const bool update_after_bind) {
+  const uint64_t key = (static_cast<uint64_t>(num_buffers) << 1) | update_after_bind;
+
+  if (const auto it = descriptor_set_layouts_.find(key); it != descriptor_set_layouts_.end()) {
+    return it->second;
+  }
+
+  const auto set_layout = create_descriptor_set_layout(num_buffers, update_after_bind);
+  descriptor_set_layouts_.emplace(key, set_layout);
+  return set_layout;
+}
+
+vk::PipelineLayout PipelineRegistry::pipeline_layout_locked(const size_t num_buffers,
+                                                            const size_t push_constant_size,
+                                                            const bool update_after_bind) {
+  const uint64_t key = (static_cast<uint64_t>(num_buffers) << 33) |
+                       (static_cast<uint64_t>(update_after_bind) << 32) | push_constant_size;
+
+  if (const auto it = pipeline_layouts_.find(key); it != pipeline_layouts_.end()) {
+    return it->second;
+  }
+
+  // Bindless pipelines have no descriptor set
+  const auto pipeline_layout = create_pipeline_layout(
+      num_buffers > 0 ? descriptor_set_layout_locked(num_buffers, update_after_bind) : nullptr,
+      push_constant_size);
+  pipeline_layouts_.emplace(key, pipeline_layout);
+  return pipeline_layout;
+}
+
+// ----------------------------------------------------------------------------
+// Creation
+// ----------------------------------------------------------------------------
+
+PipelineRegistry::ShaderEntry PipelineRegistry::create_shader_entry(
+    const std::string& shader_name) const {
+  if (!shaders::all_shaders.contains(shader_name)) {
+    throw std::runtime_error("Shader " + shader_name + " not found");
+  }
+
+  const auto [shader_binary, shader_binary_size] = shaders::all_shaders.at(shader_name);
+
+  // The embedded arrays are 'unsigned char', copy once to get 4-byte aligned words
+  std::vector<uint32_t> spirv_binary(shader_binary_size / sizeof(uint32_t));
+  std::memcpy(spirv_binary.data(), shader_binary, shader_binary_size);
+
+  if (spirv_binary.empty()) {
+    throw std::runtime_error("SPIRV binary is empty");
+  }
+
+  const vk::ShaderModuleCreateInfo create_info{
+      .codeSize = spirv_binary.size() * sizeof(uint32_t),
+      .pCode = spirv_binary.data(),
+  };
+
+  ShaderEntry entry{
+      .shader_module = device_ref_.createShaderModule(create_info),
+      .reflection = reflect_spirv(spirv_binary),
+  };
+
+  spdlog::debug("Shader module [{}] created successfully ({} bindings, {} bytes push constants)",
+                shader_name,
+                entry.reflection.bindings.size(),
+                entry.reflection.push_constant_size);
+
+  return entry;
+}
+
+vk::DescriptorSetLayout PipelineRegistry::create_descriptor_set_layout(
+    const size_t num_buffers, const bool update_after_bind) const {
+  spdlog::trace("PipelineRegistry::create_descriptor_set_layout() num_buffers: {}", num_buffers);
+
+  if (num_buffers == 0) {
+    throw std::runtime_error("Number of buffers is 0");
+  }
+
+  std::vector<vk::DescriptorSetLayoutBinding> bindings;
+  bindings.reserve(num_buffers);
+
+  for (uint32_t i = 0; i < num_buffers; ++i) {
+    bindings.emplace_back(vk::DescriptorSetLayoutBinding{
+        .binding = i,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .descriptorCount = 1,
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+    });
+  }
+
+  // Update-after-bind sets are written by their owner, never pushed
+  const std::vector<vk::DescriptorBindingFlags> binding_flags(
+      num_buffers, vk::DescriptorBindingFlagBits::eUpdateAfterBind);
+
+  const vk::DescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info{
+      .bindingCount = static_cast<uint32_t>(binding_flags.size()),
+      .pBindingFlags = binding_flags.data(),
+  };
+
+  vk::DescriptorSetLayoutCreateFlags flags;
+  if (update_after_bind) {
+    flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool;
+  } else if (push_descriptors_) {
+    flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR;
+  }
+
+  const vk::DescriptorSetLayoutCreateInfo create_info{
+      .pNext = update_after_bind ? &binding_flags_info : nullptr,
+      .flags = flags,
+      .bindingCount = static_cast<uint32_t>(bindings.size()),
+      .pBindings = bindings.data(),
+  };
+
+  return device_ref_.createDescriptorSetLayout(create_info);
+}
+
+vk::PipelineLayout PipelineRegistry::create_pipeline_layout(
+    const vk::DescriptorSetLayout set_layout, const size_t push_constant_size) const {
+  // Push Constants
+  std::vector<vk::PushConstantRange> push_constant_ranges;
+
+  if (push_constant_size > 0) {
+    push_constant_ranges.emplace_back(vk::PushConstantRange{
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        .offset = 0,
+        .size = static_cast<uint32_t>(push_constant_size),
+    });
+  }
+
+  const vk::PipelineLayoutCreateInfo create_info{
+      .setLayoutCount = set_layout ? 1u : 0u,
+      .pSetLayouts = set_layout ? &set_layout : nullptr,
+      .pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size()),
+      .pPushConstantRanges = push_constant_ranges.empty() ? nullptr : push_constant_ranges.data()};
+
+  return device_ref_.createPipelineLayout(create_info);
+}
+
+vk::Pipeline PipelineRegistry::create_pipeline(const vk::ShaderModule shader_module,
+                                               const vk::PipelineLayout pipeline_layout,
+                                               const PipelineKey& key) const {
+  spdlog::trace("PipelineRegistry::create_pipeline() [{}]", key.shader_name);
+
+  // Specialization constants, every value is a 32-bit scalar
+  const auto num_constants = key.specialization_data.size() / 2;
+
+  std::vector<vk::SpecializationMapEntry> map_entries;
+  std::vector<uint32_t> values;
+  map_entries.reserve(num_constants);
+  values.reserve(num_constants);
+
+  for (size_t i = 0; i < num_constants; ++i) {
+    map_entries.emplace_back(vk::SpecializationMapEntry{
+        .constantID = key.specialization_data[2 * i],
+        .offset = static_cast<uint32_t>(i * sizeof(uint32_t)),
+        .size = sizeof(uint32_t),
+    });
+    values.push_back(key.specialization_data[2 * i + 1]);
+  }
+
+  const vk::SpecializationInfo specialization_info{
+      .mapEntryCount = static_cast<uint32_t>(map_entries.size()),
+      .pMapEntries = map_entries.data(),
+      .dataSize = values.size() * sizeof(uint32_t),
+      .pData = values.data(),
+  };
+
+  const bool pin_subgroup_size = subgroup_size_control_ && key.required_subgroup_size > 0;
+
+  // Full subgroups are only valid when local_size_x is a multiple of the pinned width
+  const bool full_subgroups =
+      pin_subgroup_size && key.work_group_size[0] % key.required_subgroup_size == 0;
+  if (pin_subgroup_size && !full_subgroups) {
+    spdlog::warn("Pipeline [{}]: local_size_x {} is not a multiple of subgroup size {}, "
+                 "not requiring full subgroups",
+                 key.shader_name,
+                 key.work_group_size[0],
+                 key.required_subgroup_size);
+  }
+
+  const vk::PipelineShaderStageRequiredSubgroupSizeCreateInfo required_subgroup_size_info{
+      .requiredSubgroupSize = key.required_subgroup_size,
+  };
+
+  const vk::PipelineShaderStageCreateInfo shader_stage_create_info{
+      .pNext = pin_subgroup_size ? &required_subgroup_size_info : nullptr,
+      .flags = full_subgroups ? vk::PipelineShaderStageCreateFlagBits::eRequireFullSubgroups
+                              : vk::PipelineShaderStageCreateFlags{},
+      .stage = vk::ShaderStageFlagBits::eCompute,
+      .module = shader_module,
+      .pName = "main",
+      .pSpecializationInfo = map_entries.empty() ? nullptr : &specialization_info,
+  };
+
+  const vk::ComputePipelineCreateInfo pipeline_create_info{
+      .stage = shader_stage_create_info,
+      .layout = pipeline_layout,
+      .basePipelineHandle = nullptr,
+  };
+
+  const auto pipeline =
+      device_ref_.createComputePipeline(pipeline_cache_ref_, pipeline_create_info).value;
+
+  spdlog::debug("Pipeline [{}] created successfully", key.shader_name);
+
+  return pipeline;
+}
+
+}  // namespace vulkan
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "spirv_reflect.hpp"
+#include "vk.hpp"
+
+namespace vulkan {
+
+// Everything that makes two compute pipelines interchangeable
+struct PipelineKey {
+  std::string shader_name;
+  size_t num_buffers = 0;
+  size_t push_constant_size = 0;
+  std::array<uint32_t, 3> work_group_size = {0, 0, 0};
+
+  // Flattened (constant_id, value) pairs, sorted by constant_id
+  std::vector<uint32_t> specialization_data;
+
+  // Pin the subgroup width the pipeline runs with, 0 leaves it to the driver
+  uint32_t required_subgroup_size = 0;
+
+  // Laid out for update-after-bind descriptor sets instead of the default binding model
+  bool update_after_bind = false;
+
+  bool operator==(const PipelineKey&) const = default;
+};
+
+struct PipelineKeyHash {
+  size_t operator()(const PipelineKey& key) const noexcept;
+};
+
+// ----------------------------------------------------------------------------
+// PipelineRegistry
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Engine-level intern table for the immutable parts of an 'Algorithm'
+ *
+ * Shader modules, descriptor set layouts, pipeline layouts and pipelines are
+ * created once per unique key and shared by every 'Algorithm' that asks for
+ * them. The registry owns all handles and destroys them on destruction, so
+ * an 'Algorithm' only owns its descriptor state.
+ *
+ * All getters are thread safe.
+ */
+class PipelineRegistry {
+ public:
+  /**
+   * @param subgroup_size_control Pin pipelines to their required subgroup size
+   * @param push_descriptors Create set layouts for VK_KHR_push_descriptor, so buffers are
+   *                         pushed into the command buffer instead of written to sets
+   */
+  explicit PipelineRegistry(vk::Device device,
+                            vk::PipelineCache pipeline_cache,
+                            bool subgroup_size_control = false,
+                            bool push_descriptors = false);
+
+  ~PipelineRegistry();
+
+  PipelineRegistry(const PipelineRegistry&) = delete;
+  PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+  [[nodiscard]] vk::Device get_device() const { return device_ref_; }
+
+  [[nodiscard]] bool uses_push_descriptors() const { return push_descriptors_; }
+
+  [[nodiscard]] vk::ShaderModule get_shader_module(const std::string& shader_name);
+
+  // Reflection data stays valid for the lifetime of the registry
+  [[nodiscard]] const ShaderReflection& get_reflection(const std::string& shader_name);
+
+  /**
+   * @param update_after_bind Layout for sets from an update-after-bind pool, whose
+   *                          descriptors can be rewritten while a recording binds them
+   */
+  [[nodiscard]] vk::DescriptorSetLayout get_descriptor_set_layout(size_t num_buffers,
+                                                                  bool update_after_bind = false);
+  [[nodiscard]] vk::PipelineLayout get_pipeline_layout(size_t num_buffers,
+                                                       size_t push_constant_size,
+                                                       bool update_after_bind = false);
+  [[nodiscard]] vk::Pipeline get_pipeline(const PipelineKey& key);
+
+  // Writes all 'num_buffers' bindings of a set from a packed 'vk::DescriptorBufferInfo' array
+  [[nodiscard]] vk::DescriptorUpdateTemplate get_update_template(size_t num_buffers);
+
+ private:
+  struct ShaderEntry {
+    vk::ShaderModule shader_module;
+    ShaderReflection reflection;
+  };
+
+  [[nodiscard]] ShaderEntry create_shader_entry(const std::string& shader_name) const;
+  [[nodiscard]] vk::DescriptorSetLayout create_descriptor_set_layout(
+      size_t num_buffers, bool update_after_bind) const;
+  [[nodiscard]] vk::PipelineLayout create_pipeline_layout(vk::DescriptorSetLayout set_layout,
+                                                          size_t push_constant_size) const;
+  [[nodiscard]] vk::Pipeline create_pipeline(vk::ShaderModule shader_module,
+                                             vk::PipelineLayout pipeline_layout,
+                                             const PipelineKey& key) const;
+
+  // Unlocked versions, 'mutex_' must be held
+  const ShaderEntry& shader_entry_locked(const std::string& shader_name);
+  vk::DescriptorSetLayout descriptor_set_layout_locked(size_t num_buffers, bool update_after_bind);
+  vk::PipelineLayout pipeline_layout_locked(size_t num_buffers,
+                                            size_t push_constant_size,
+                                            bool update_after_bind);
+
+  vk::Device device_ref_;
+  vk::PipelineCache pipeline_cache_ref_;
+  bool subgroup_size_control_;
+  bool push_descriptors_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, ShaderEntry> shader_entries_;
+  std::unordered_map<uint64_t, vk::DescriptorSetLayout> descriptor_set_layouts_;
+  std::unordered_map<uint64_t, vk::PipelineLayout> pipeline_layouts_;
+  std::unordered_map<size_t, vk::DescriptorUpdateTemplate> update_templates_;
+  std::unordered_map<PipelineKey, vk::Pipeline, PipelineKeyHash> pipelines_;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,125 @@
+#include "radix_sort.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+
+#include "tracer.hpp"
+
+namespace vulkan {
+
+RadixSort::RadixSort(Kernels kernels,
+                     std::shared_ptr<Scan> scan,
+                     VulkanMemoryResource* mr_ptr,
+                     const uint32_t key_bits,
+                     const uint32_t value_bytes)
+    : kernels_(std::move(kernels)),
+      scan_(std::move(scan)),
+      key_words_(key_bits / 32),
+      value_words_(value_bytes / 4),
+      keys_alt_(mr_ptr),
+      values_alt_(mr_ptr),
+      global_histogram_(mr_ptr),
+      tile_histogram_(mr_ptr) {
+  if (key_bits != 32 && key_bits != 64) {
+    throw std::runtime_error("RadixSort keys must be 32 or 64 bits, got " +
+                             std::to_string(key_bits));
+  }
+  if (value_bytes % 4 != 0) {
+    throw std::runtime_error("RadixSort value size must be a multiple of 4 bytes, got " +
+                             std::to_string(value_bytes));
+  }
+}
+
+void RadixSort::reserve(const uint32_t n) {
+  keys_alt_.reserve(size_t{n} * key_words_);
+  values_alt_.reserve(size_t{n} * value_words_);
+  global_histogram_.reserve(size_t{key_words_} * 4 * kRadix);
+  tile_histogram_.reserve(size_t{kRadix} * div_ceil(n, kTileSize));
+}
+
+void RadixSort::record(Sequence& seq,
+                       const vk::DescriptorBufferInfo& keys,
+                       const uint32_t n,
+                       const std::optional<vk::DescriptorBufferInfo>& values) {
+  spdlog::trace("RadixSort::record() n: {}", n);
+  const ScopedTrace trace("RadixSort::record");
+
+  if (values.has_value() != (value_words_ > 0)) {
+    throw std::runtime_error(value_words_ > 0 ? "RadixSort was made for key-value pairs"
+                                              : "RadixSort was made for keys only");
+  }
+
+  if (n <= 1) {
+    return;
+  }
+
+  const auto num_tiles = static_cast<uint32_t>(div_ceil(n, kTileSize));
+  const std::array<uint32_t, 3> grid_size{std::min(num_tiles, kMaxWorkGroupCount), 1, 1};
+
+  const auto keys_alt = keys_alt_.get(seq, size_t{n} * key_words_);
+
+  const auto [values_a, values_b] =
+      get_sort_values(seq, values, values_alt_, size_t{n} * value_words_, keys, keys_alt);
+  const auto global_histogram = global_histogram_.get(seq, size_t{key_words_} * 4 * kRadix);
+
+  // Exactly this sort's tiles, the scan covers the whole range
+  const auto tile_histogram = tile_histogram_.get(seq, size_t{kRadix} * num_tiles);
+
+  // Histograms of all passes
+  seq.record_fill(global_histogram.buffer, global_histogram.offset, global_histogram.range, 0);
+
+  kernels_.histogram->update_push_constant(n);
+  kernels_.histogram->update_buffer({keys, global_histogram});
+  seq.record_dispatch(kernels_.histogram.get(), grid_size);
+
+  // Digit passes, skipped ones exit early on the device
+  for (uint32_t pass = 0; pass < key_words_ * 4; ++pass) {
+    const PushConstants pc{
+        .num_elements = n,
+        .num_tiles = num_tiles,
+        .pass = pass,
+    };
+
+    kernels_.upsweep->update_push_constant(pc);
+    kernels_.upsweep->update_buffer({keys, keys_alt, global_histogram, tile_histogram});
+    seq.record_dispatch(kernels_.upsweep.get(), grid_size);
+
+    scan_->record(seq, tile_histogram, tile_histogram, kRadix * num_tiles, ScanMode::kExclusive);
+
+    kernels_.downsweep->update_push_constant(pc);
+    kernels_.downsweep->update_buffer(
+        {keys, keys_alt, values_a, values_b, global_histogram, tile_histogram});
+    seq.record_dispatch(kernels_.downsweep.get(), grid_size);
+  }
+
+  // Odd number of passes done, the result is in the temporaries
+  kernels_.copy->update_push_constant(n);
+  kernels_.copy->update_buffer({keys, keys_alt, values_a, values_b, global_histogram});
+  seq.record_dispatch(kernels_.copy.get(), grid_size);
+}
+
+void RadixSort::record_argsort(Sequence& seq,
+                               const vk::DescriptorBufferInfo& keys,
+                               const uint32_t n,
+                               const vk::DescriptorBufferInfo& indices) {
+  if (value_words_ != 1) {
+    throw std::runtime_error("RadixSort::record_argsort() needs a sort with 4-byte values");
+  }
+
+  if (n == 0) {
+    return;
+  }
+
+  // Identity permutation, the sort then carries each index to its key's position
+  kernels_.iota->update_push_constant(n);
+  kernels_.iota->update_buffer({indices});
+
+  const auto num_groups = static_cast<uint32_t>(div_ceil(n, kWorkGroupSize));
+  seq.record_dispatch(kernels_.iota.get(), {std::min(num_groups, kMaxWorkGroupCount), 1, 1});
+
+  record(seq, keys, n, indices);
+}
+
+}  // namespace vulkan
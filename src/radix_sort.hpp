@@ -0,0 +1,119 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include "algorithm.hpp"
+#include "scan.hpp"
+#include "scratch_buffer.hpp"
+#include "sequence.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// RadixSort
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Device-wide stable LSD radix sort of 32- or 64-bit unsigned keys
+ *
+ * Reduce-then-scan with 8-bit digits, spread over as many work groups as the
+ * input has tiles (at most 'kMaxWorkGroupCount', which then loop over the rest):
+ *   1. one read of the keys builds the digit histograms of all passes
+ *   2. per pass, each tile counts its digits ('prim_radix_upsweep')
+ *   3. a 'Scan' of the counts gives every (digit, tile) its output offset
+ *   4. each tile ranks its keys stably and scatters them ('prim_radix_downsweep')
+ *
+ * Passes in which every key has the same digit (e.g. the high bytes of Morton
+ * codes of a small scene) are skipped on the device, without a readback.
+ * Keys ping-pong through a temporary buffer and end up back in the input.
+ * Values, if the sort was made with a value size, are moved along with them;
+ * they can be any fixed-size struct (see 'Engine::make_key_value_sort()').
+ *
+ * Example usage:
+ * ```cpp
+ * auto sort = engine.make_radix_sort(32);
+ * seq->cmd_begin();
+ * seq->record_dispatch(morton.get(), {div_ceil(n, 256), 1, 1});
+ * sort->record(*seq, engine.get_buffer_info(morton_codes), n);
+ * seq->cmd_end();
+ * seq->launch_kernel_async();
+ * seq->sync();
+ * ```
+ */
+class RadixSort {
+ public:
+  static constexpr uint32_t kWorkGroupSize = 256;
+  static constexpr uint32_t kTileSize = kWorkGroupSize * 4;
+  static constexpr uint32_t kRadix = 256;
+
+  // Built 'prim_radix_*' Algorithms, see 'Engine::make_radix_sort()'
+  struct Kernels {
+    std::shared_ptr<Algorithm> histogram;
+    std::shared_ptr<Algorithm> upsweep;
+    std::shared_ptr<Algorithm> downsweep;
+    std::shared_ptr<Algorithm> copy;
+    std::shared_ptr<Algorithm> iota;
+  };
+
+  /**
+   * @param key_bits 32 or 64
+   * @param value_bytes Size of the value moved with each key, a multiple of 4; 0 for keys only
+   */
+  explicit RadixSort(Kernels kernels,
+                     std::shared_ptr<Scan> scan,
+                     VulkanMemoryResource* mr_ptr,
+                     uint32_t key_bits,
+                     uint32_t value_bytes = 0);
+
+  RadixSort(const RadixSort&) = delete;
+  RadixSort& operator=(const RadixSort&) = delete;
+
+  /**
+   * @brief Append a sort of 'n' keys (and values) to the recording of 'seq'
+   * @param keys 'n' keys, sorted in place
+   * @param values 'n' values, required if and only if the sort was made with a value size
+   */
+  void record(Sequence& seq,
+              const vk::DescriptorBufferInfo& keys,
+              uint32_t n,
+              const std::optional<vk::DescriptorBufferInfo>& values = std::nullopt);
+
+  /**
+   * @brief Sort 'n' keys in place and write the permutation that sorts them to 'indices'
+   *
+   * 'indices[i]' is the input position of the i-th smallest key, which is
+   * what 'Gather' needs to reorder per-point attributes. Requires a sort made
+   * with 4-byte values.
+   */
+  void record_argsort(Sequence& seq,
+                      const vk::DescriptorBufferInfo& keys,
+                      uint32_t n,
+                      const vk::DescriptorBufferInfo& indices);
+
+  // Allocate the temporaries for up to 'n' keys up front
+  void reserve(uint32_t n);
+
+  [[nodiscard]] uint32_t get_key_bits() const { return key_words_ * 32; }
+  [[nodiscard]] uint32_t get_value_bytes() const { return value_words_ * 4; }
+
+ private:
+  struct PushConstants {
+    uint32_t num_elements;
+    uint32_t num_tiles;
+    uint32_t pass;
+  };
+
+  Kernels kernels_;
+  std::shared_ptr<Scan> scan_;
+  uint32_t key_words_;
+  uint32_t value_words_;
+
+  // Ping-pong keys and values, digit counts of all passes and per-tile digit counts
+  ScratchBuffer keys_alt_;
+  ScratchBuffer values_alt_;
+  ScratchBuffer global_histogram_;
+  ScratchBuffer tile_histogram_;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,43 @@
+#include "scan.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "tracer.hpp"
+
+namespace vulkan {
+
+Scan::Scan(std::shared_ptr<Algorithm> algo, VulkanMemoryResource* mr_ptr)
+    : algo_(std::move(algo)), tile_state_(mr_ptr) {
+  if (algo_->get_shader_name() != "prim_scan") {
+    throw std::runtime_error("Scan needs a prim_scan Algorithm, got " + algo_->get_shader_name());
+  }
+}
+
+void Scan::record(Sequence& seq,
+                  const vk::DescriptorBufferInfo& input,
+                  const vk::DescriptorBufferInfo& output,
+                  const uint32_t n,
+                  const ScanMode mode) {
+  spdlog::trace("Scan::record() n: {}", n);
+  const ScopedTrace trace("Scan::record");
+
+  if (n == 0) {
+    return;
+  }
+
+  const auto num_tiles = static_cast<uint32_t>(div_ceil(n, kTileSize));
+
+  const auto tile_state = tile_state_.record(seq, num_tiles);
+
+  algo_->update_push_constant(PushConstants{
+      .num_elements = n,
+      .inclusive = mode == ScanMode::kInclusive ? 1u : 0u,
+  });
+  algo_->update_buffer({input, output, tile_state});
+
+  seq.record_dispatch(algo_.get(), {std::min(num_tiles, kMaxWorkGroupCount), 1, 1});
+}
+
+}  // namespace vulkan
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <memory>
+
+#include "algorithm.hpp"
+#include "lookback.hpp"
+#include "sequence.hpp"
+
+namespace vulkan {
+
+// Element types the device-wide primitives operate on
+enum class ElementType {
+  kUint,
+  kInt,
+  kFloat,
+};
+
+enum class ScanMode {
+  kInclusive,
+  kExclusive,
+};
+
+// ----------------------------------------------------------------------------
+// Scan
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Device-wide prefix sum of any length in a single pass
+ *
+ * Backed by 'prim_scan.comp', a chained scan with decoupled look-back: every
+ * element is read and written exactly once, with no second level of block
+ * sums. A Scan only records commands, so several scans (and other dispatches)
+ * can share one submission; 'Sequence' orders them by the buffers they touch.
+ *
+ * Example usage:
+ * ```cpp
+ * auto scan = engine.make_scan(ElementType::kUint);
+ * seq->cmd_begin();
+ * scan->record(*seq, engine.get_buffer_info(edge_count), engine.get_buffer_info(offsets), n,
+ *              ScanMode::kExclusive);
+ * seq->cmd_end();
+ * seq->launch_kernel_async();
+ * seq->sync();
+ * ```
+ */
+class Scan {
+ public:
+  // Elements per work group, must match 'prim_scan.comp'
+  static constexpr uint32_t kWorkGroupSize = 256;
+  static constexpr uint32_t kTileSize = kWorkGroupSize * 4;
+
+  // 'algo' is a built 'prim_scan' Algorithm, see 'Engine::make_scan()'
+  explicit Scan(std::shared_ptr<Algorithm> algo, VulkanMemoryResource* mr_ptr);
+
+  Scan(const Scan&) = delete;
+  Scan& operator=(const Scan&) = delete;
+
+  /**
+   * @brief Append a scan of 'n' elements to the recording of 'seq'
+   * @param input At least 'n' elements, read only
+   * @param output At least 'n' elements, may be the same range as 'input'
+   *
+   * Dispatches a work group per tile, at most 'kMaxWorkGroupCount'; past that
+   * the work groups claim the remaining tiles in turn.
+   */
+  void record(Sequence& seq,
+              const vk::DescriptorBufferInfo& input,
+              const vk::DescriptorBufferInfo& output,
+              uint32_t n,
+              ScanMode mode = ScanMode::kInclusive);
+
+ private:
+  struct PushConstants {
+    uint32_t num_elements;
+    uint32_t inclusive;
+  };
+
+  std::shared_ptr<Algorithm> algo_;
+
+  LookbackState tile_state_;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,48 @@
+#include "scratch_buffer.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace vulkan {
+
+ScratchBuffer::ScratchBuffer(VulkanMemoryResource* mr_ptr) : mr_ptr_(mr_ptr) {}
+
+void ScratchBuffer::reserve(const size_t words) {
+  if (capacity() >= words) {
+    return;
+  }
+
+  spdlog::debug("ScratchBuffer: growing to {} words", words);
+
+  // Recordings retained the old storage, dropping it here does not free it under them
+  storage_ = std::make_shared<std::pmr::vector<uint32_t>>(words, mr_ptr_);
+}
+
+vk::DescriptorBufferInfo ScratchBuffer::get(Sequence& seq, size_t words) {
+  words = std::max<size_t>(words, 1);
+  reserve(words);
+  seq.retain(storage_);
+
+  const auto slice = mr_ptr_->get_buffer_slice(storage_->data());
+  return vk::DescriptorBufferInfo{
+      .buffer = slice.buffer,
+      .offset = slice.offset,
+      .range = words * sizeof(uint32_t),
+  };
+}
+
+std::pair<vk::DescriptorBufferInfo, vk::DescriptorBufferInfo> get_sort_values(
+    Sequence& seq,
+    const std::optional<vk::DescriptorBufferInfo>& values,
+    ScratchBuffer& values_alt,
+    const size_t words,
+    const vk::DescriptorBufferInfo& keys,
+    const vk::DescriptorBufferInfo& keys_alt) {
+  if (!values.has_value()) {
+    return {keys, keys_alt};
+  }
+  return {*values, values_alt.get(seq, words)};
+}
+
+}  // namespace vulkan
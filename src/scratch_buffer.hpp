@@ -0,0 +1,67 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "sequence.hpp"
+#include "vma_pmr.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// ScratchBuffer
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Grow-only device memory for a temporary of a recorded primitive
+ *
+ * 'get()' hands out the first 'words' 32-bit words of the current storage,
+ * growing it when needed. Growing does not wait for the GPU: recordings that
+ * reference the old storage keep it alive through 'Sequence::retain()', so it
+ * is freed once the last of them completed and was recycled by 'cmd_begin()',
+ * instead of piling up until the primitive is destroyed.
+ *
+ * Example usage:
+ * ```cpp
+ * ScratchBuffer counts(mr_ptr);
+ * const auto info = counts.get(seq, num_tiles);
+ * seq.record_fill(info.buffer, info.offset, info.range, 0);
+ * algo->update_buffer({input, info});
+ * ```
+ */
+class ScratchBuffer {
+ public:
+  explicit ScratchBuffer(VulkanMemoryResource* mr_ptr);
+
+  // 'words' words (at least one) for the recording of 'seq', which keeps them alive
+  [[nodiscard]] vk::DescriptorBufferInfo get(Sequence& seq, size_t words);
+
+  // Allocate room for 'words' words up front
+  void reserve(size_t words);
+
+  [[nodiscard]] size_t capacity() const { return storage_ ? storage_->size() : 0; }
+
+ private:
+  VulkanMemoryResource* mr_ptr_;
+  std::shared_ptr<std::pmr::vector<uint32_t>> storage_;
+};
+
+/**
+ * @brief Value bindings of a sort: the caller's values and a temporary to ping-pong with
+ * @param words Value words of the whole sort, 0 for keys only
+ *
+ * Keys-only sorts bind the key buffers in place of the (never accessed)
+ * values, so 'RadixSort' and 'MergeSort' kernels keep a single layout.
+ */
+[[nodiscard]] std::pair<vk::DescriptorBufferInfo, vk::DescriptorBufferInfo> get_sort_values(
+    Sequence& seq,
+    const std::optional<vk::DescriptorBufferInfo>& values,
+    ScratchBuffer& values_alt,
+    size_t words,
+    const vk::DescriptorBufferInfo& keys,
+    const vk::DescriptorBufferInfo& keys_alt);
+
+}  // namespace vulkan
@@ -1,18 +1,61 @@
 #include "sequence.hpp"
 
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include "tracer.hpp"
+
 namespace vulkan {
 
+namespace {
+
+// Size of a tracked range for flush/invalidate, open-ended ranges came from VK_WHOLE_SIZE
+vk::DeviceSize to_vma_size(const auto& range) {
+  return range.end == std::numeric_limits<vk::DeviceSize>::max() ? VK_WHOLE_SIZE
+                                                                  : range.end - range.begin;
+}
+
+}  // namespace
+
 Sequence::Sequence(const vk::Device device_ref,
                    const vk::Queue compute_queue_ref,
-                   const uint32_t compute_queue_index)
+                   const uint32_t compute_queue_index,
+                   const vk::QueueFlags queue_flags)
     : device_ref_(device_ref),
       compute_queue_ref_(compute_queue_ref),
-      compute_queue_index_(compute_queue_index) {
+      compute_queue_index_(compute_queue_index),
+      barrier_stages_(vk::PipelineStageFlagBits::eTransfer),
+      barrier_src_access_(vk::AccessFlagBits::eTransferWrite),
+      barrier_dst_access_(vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite) {
   spdlog::trace("Sequence constructor");
 
+  if (queue_flags & vk::QueueFlagBits::eCompute) {
+    barrier_stages_ |=
+        vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect;
+    barrier_src_access_ |= vk::AccessFlagBits::eShaderWrite;
+    barrier_dst_access_ |= vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite |
+                           vk::AccessFlagBits::eIndirectCommandRead;
+  }
+
   create_sync_objects();
   create_command_pool();
-  create_command_buffer();
+}
+
+Sequence::~Sequence() { destroy(); }
+
+void Sequence::destroy() {
+  spdlog::trace("Sequence::destroy()");
+
+  // The command buffers and semaphore must not be in use anymore
+  sync();
+  recordings_.clear();
+
+  if (query_pool_) {
+    device_ref_.destroyQueryPool(query_pool_);
+  }
+  device_ref_.destroyCommandPool(command_pool_);
+  device_ref_.destroySemaphore(timeline_);
 }
 
 void Sequence::create_command_pool() {
@@ -29,30 +72,95 @@ void Sequence::create_command_pool() {
 void Sequence::create_sync_objects() {
   spdlog::trace("Sequence::create_sync_objects()");
 
-  constexpr vk::FenceCreateInfo create_info{};
-  fence_ = device_ref_.createFence(create_info);
+  constexpr vk::SemaphoreTypeCreateInfo type_info{
+      .semaphoreType = vk::SemaphoreType::eTimeline,
+      .initialValue = 0,
+  };
+
+  const vk::SemaphoreCreateInfo create_info{
+      .pNext = &type_info,
+  };
+
+  timeline_ = device_ref_.createSemaphore(create_info);
 }
 
-void Sequence::create_command_buffer() {
-  spdlog::trace("Sequence::create_command_buffer()");
+size_t Sequence::acquire_recording() {
+  const auto completed = device_ref_.getSemaphoreCounterValue(timeline_);
 
-  const vk::CommandBufferAllocateInfo allocate_info{
-      .commandPool = command_pool_,
-      .level = vk::CommandBufferLevel::ePrimary,
-      .commandBufferCount = 1,
-  };
+  // The latest one first, so a loop that syncs every iteration keeps one command buffer
+  if (!recordings_.empty() && recordings_[current_].submitted_value <= completed) {
+    return current_;
+  }
+  for (size_t i = 0; i < recordings_.size(); ++i) {
+    if (recordings_[i].submitted_value <= completed) {
+      return i;
+    }
+  }
 
-  handle_ = device_ref_.allocateCommandBuffers(allocate_info).front();
+  if (recordings_.size() < kMaxRecordings) {
+    spdlog::trace("Sequence: recording #{} created", recordings_.size());
+
+    const vk::CommandBufferAllocateInfo allocate_info{
+        .commandPool = command_pool_,
+        .level = vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = 1,
+    };
+
+    Recording recording;
+    recording.handle = device_ref_.allocateCommandBuffers(allocate_info).front();
+    recording.descriptor_ring = std::make_unique<DescriptorRing>(device_ref_);
+    recordings_.push_back(std::move(recording));
+    return recordings_.size() - 1;
+  }
+
+  // All in flight, submissions signal in order so the oldest completes first
+  const auto oldest = std::ranges::min_element(recordings_, {}, &Recording::submitted_value);
+  Future(device_ref_, timeline_, oldest->submitted_value).wait();
+  return static_cast<size_t>(std::distance(recordings_.begin(), oldest));
 }
 
-void Sequence::cmd_begin() const {
+void Sequence::cmd_begin(const bool one_time_submit) {
   spdlog::trace("Sequence::cmd_begin()");
 
-  constexpr vk::CommandBufferBeginInfo begin_info{
-      .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+  current_ = acquire_recording();
+  auto& recording = current();
+  handle_ = recording.handle;
+
+  // Host-side work of the completed submissions that nobody waited on
+  on_complete(recording.submitted_value);
+  if (recording.gpu_spans_pending) {
+    trace_gpu_spans(recording);
+  }
+
+  // Sets and memory of the previous use are no longer referenced by a pending submission
+  recording.descriptor_ring->reset();
+  recording.retained.clear();
+  recording.reads.clear();
+  recording.writes.clear();
+  recording.timed_dispatch_labels.clear();
+
+  pending_reads_.clear();
+  pending_writes_.clear();
+  untracked_pending_ = false;
+
+  const vk::CommandBufferBeginInfo begin_info{
+      .flags = one_time_submit ? vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+                               : vk::CommandBufferUsageFlagBits::eSimultaneousUse,
   };
 
   handle_.begin(begin_info);
+
+  // A reusable recording may be submitted again while the previous submission still writes
+  // its queries, and the in-command-buffer reset would race with it, so it is not timed
+  timed_recording_ = query_pool_ && one_time_submit;
+  untimed_warned_ = false;
+  recording.first_query = static_cast<uint32_t>(current_ * 2 * max_timed_dispatches_);
+
+  if (timed_recording_) {
+    handle_.resetQueryPool(query_pool_, recording.first_query, 2 * max_timed_dispatches_);
+  } else if (query_pool_) {
+    spdlog::debug("Sequence: reusable recording, dispatches are not timed");
+  }
 }
 
 void Sequence::cmd_end() const {
@@ -61,42 +169,473 @@ void Sequence::cmd_end() const {
   handle_.end();
 }
 
-void Sequence::launch_kernel_async() const {
-  spdlog::trace("Sequence::launch_kernel_async()");
+Future Sequence::launch_kernel_async(const std::span<const Future> wait_on) {
+  spdlog::trace("Sequence::launch_kernel_async() waiting on {} futures", wait_on.size());
+  const ScopedTrace trace("Sequence::submit");
+
+  std::vector<vk::Semaphore> wait_semaphores;
+  std::vector<uint64_t> wait_values;
+  wait_semaphores.reserve(wait_on.size());
+  wait_values.reserve(wait_on.size());
+
+  for (const auto& future : wait_on) {
+    if (future.valid()) {
+      wait_semaphores.push_back(future.get_semaphore());
+      wait_values.push_back(future.get_value());
+    }
+  }
+
+  // Submissions of one Sequence run in order, its recordings are not separated by barriers
+  if (submitted_value_ > 0) {
+    wait_semaphores.push_back(timeline_);
+    wait_values.push_back(submitted_value_);
+  }
+
+  const std::vector<vk::PipelineStageFlags> wait_stages(wait_semaphores.size(),
+                                                        vk::PipelineStageFlagBits::eAllCommands);
+
+  const uint64_t signal_value = submitted_value_ + 1;
+
+  const vk::TimelineSemaphoreSubmitInfo timeline_info{
+      .waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size()),
+      .pWaitSemaphoreValues = wait_values.data(),
+      .signalSemaphoreValueCount = 1,
+      .pSignalSemaphoreValues = &signal_value,
+  };
 
   const vk::SubmitInfo submit_info{
+      .pNext = &timeline_info,
+      .waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size()),
+      .pWaitSemaphores = wait_semaphores.data(),
+      .pWaitDstStageMask = wait_stages.data(),
       .commandBufferCount = 1,
       .pCommandBuffers = &handle_,
+      .signalSemaphoreCount = 1,
+      .pSignalSemaphores = &timeline_,
   };
 
-  compute_queue_ref_.submit(submit_info, fence_);
+  auto& recording = current();
+
+  // Host writes to non-coherent memory become visible to this submission
+  if (mr_ptr_ && mr_ptr_->has_non_coherent_memory()) {
+    for (const auto& r : recording.reads) {
+      mr_ptr_->flush_range(r.buffer, r.begin, to_vma_size(r));
+    }
+    recording.invalidate_pending = true;
+  }
+
+  if (timed_recording_ && Tracer::instance().is_enabled()) {
+    recording.submit_host_ns = Tracer::instance().now_ns();
+    recording.gpu_spans_pending = true;
+  }
+
+  compute_queue_ref_.submit(submit_info);
+
+  submitted_value_ = signal_value;
+  recording.submitted_value = signal_value;
+  latest_submitted_ = current_;
+  return Future(device_ref_, timeline_, signal_value, weak_from_this());
 }
 
-void Sequence::sync() const {
+void Sequence::sync() {
   spdlog::trace("Sequence::sync()");
 
-  if (device_ref_.waitForFences(1, &fence_, true, UINT64_MAX) != vk::Result::eSuccess) {
-    throw std::runtime_error("Failed to sync sequence");
+  {
+    const ScopedTrace trace("Sequence::sync");
+
+    // Submissions on one queue signal in order, so the latest value covers all of them
+    Future(device_ref_, timeline_, submitted_value_).wait();
   }
 
-  if (device_ref_.resetFences(1, &fence_) != vk::Result::eSuccess) {
-    throw std::runtime_error("Failed to reset sequence");
+  on_complete(submitted_value_);
+
+  for (auto& recording : recordings_) {
+    if (recording.gpu_spans_pending) {
+      trace_gpu_spans(recording);
+    }
   }
 }
 
-void Sequence::record_commands(const Algorithm* algo,
-                               const std::array<uint32_t, 3> grid_size) const {
-  spdlog::trace("Sequence::record_commands()");
+void Sequence::retain(std::shared_ptr<const void> resource) {
+  auto& retained = current().retained;
 
-  cmd_begin();
+  // Primitives recorded several times per recording hand in the same storage
+  if (std::ranges::find(retained, resource) == retained.end()) {
+    retained.push_back(std::move(resource));
+  }
+}
+
+void Sequence::on_complete(const uint64_t value) {
+  for (auto& recording : recordings_) {
+    // Earlier submissions of a recording may complete while its latest still writes
+    if (!recording.invalidate_pending || value < recording.submitted_value) {
+      continue;
+    }
+
+    recording.invalidate_pending = false;
+    for (const auto& r : recording.writes) {
+      mr_ptr_->invalidate_range(r.buffer, r.begin, to_vma_size(r));
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Profiling
+// ----------------------------------------------------------------------------
+
+void Sequence::enable_profiling(const float timestamp_period,
+                                const uint32_t timestamp_valid_bits,
+                                const uint32_t max_dispatches,
+                                const bool calibrated_timestamps) {
+  spdlog::trace("Sequence::enable_profiling() max_dispatches: {}", max_dispatches);
+
+  if (timestamp_valid_bits == 0 || timestamp_period == 0.0f) {
+    throw std::runtime_error("Timestamps are not supported on this queue");
+  }
+  if (query_pool_) {
+    throw std::runtime_error("Profiling is already enabled");
+  }
+
+  // One range per recording, so submissions of different recordings never share queries
+  const vk::QueryPoolCreateInfo create_info{
+      .queryType = vk::QueryType::eTimestamp,
+      .queryCount = static_cast<uint32_t>(kMaxRecordings * 2 * max_dispatches),
+  };
+
+  query_pool_ = device_ref_.createQueryPool(create_info);
+  max_timed_dispatches_ = max_dispatches;
+  timestamp_period_ = timestamp_period;
+  calibrated_timestamps_ = calibrated_timestamps;
+  timestamp_mask_ =
+      timestamp_valid_bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << timestamp_valid_bits) - 1;
+}
+
+std::vector<DispatchTiming> Sequence::get_timings() const {
+  if (recordings_.empty()) {
+    return {};
+  }
+  return get_timings(recordings_[latest_submitted_]);
+}
+
+std::vector<DispatchTiming> Sequence::get_timings(const Recording& recording) const {
+  const auto& labels = recording.timed_dispatch_labels;
+  if (!query_pool_ || labels.empty()) {
+    return {};
+  }
+
+  const auto num_queries = static_cast<uint32_t>(2 * labels.size());
+
+  const auto [result, ticks] = device_ref_.getQueryPoolResults<uint64_t>(
+      query_pool_,
+      recording.first_query,
+      num_queries,
+      num_queries * sizeof(uint64_t),
+      sizeof(uint64_t),
+      vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+
+  if (result != vk::Result::eSuccess) {
+    throw std::runtime_error("Failed to read timestamp queries");
+  }
+
+  const auto to_ns = [this](const uint64_t t) {
+    return static_cast<uint64_t>(static_cast<double>(t & timestamp_mask_) * timestamp_period_);
+  };
+
+  std::vector<DispatchTiming> timings;
+  timings.reserve(labels.size());
+
+  for (size_t i = 0; i < labels.size(); ++i) {
+    timings.push_back(DispatchTiming{
+        .shader_name = labels[i],
+        .begin_ns = to_ns(ticks[2 * i]),
+        .end_ns = to_ns(ticks[2 * i + 1]),
+    });
+  }
+
+  return timings;
+}
+
+void Sequence::trace_gpu_spans(Recording& recording) {
+  recording.gpu_spans_pending = false;
+
+  const auto timings = get_timings(recording);
+  if (timings.empty()) {
+    return;
+  }
+
+  auto& tracer = Tracer::instance();
+
+  // Host time of the device tick 0 (after masking), both in nanoseconds
+  int64_t device_to_host_ns = 0;
+
+  if (calibrated_timestamps_) {
+    const std::array infos = {
+        vk::CalibratedTimestampInfoEXT{.timeDomain = vk::TimeDomainEXT::eDevice},
+        vk::CalibratedTimestampInfoEXT{.timeDomain = vk::TimeDomainEXT::eClockMonotonic},
+    };
+    const auto [timestamps, max_deviation] = device_ref_.getCalibratedTimestampsEXT(infos);
+
+    const auto device_ns =
+        static_cast<int64_t>(static_cast<double>(timestamps[0] & timestamp_mask_) *
+                             timestamp_period_);
+    device_to_host_ns = static_cast<int64_t>(tracer.from_steady_ns(
+                            static_cast<int64_t>(timestamps[1]))) -
+                        device_ns;
+
+    spdlog::trace("Sequence: calibrated GPU clock, max deviation {} ns", max_deviation);
+    tracer.set_metadata("gpu_clock", "calibrated (VK_EXT_calibrated_timestamps)");
+  } else {
+    // Without calibration, the first dispatch is placed at the submit time
+    // and the rest keep their GPU offsets
+    device_to_host_ns = static_cast<int64_t>(recording.submit_host_ns) -
+                        static_cast<int64_t>(timings.front().begin_ns);
+
+    tracer.set_metadata("gpu_clock",
+                        "uncalibrated: GPU spans of each submission start at its submit time");
+  }
+
+  for (const auto& t : timings) {
+    tracer.record(TraceEvent{
+        .name = t.shader_name,
+        .category = "gpu",
+        .begin_ns = static_cast<uint64_t>(static_cast<int64_t>(t.begin_ns) + device_to_host_ns),
+        .end_ns = static_cast<uint64_t>(static_cast<int64_t>(t.end_ns) + device_to_host_ns),
+        .thread_id = 0,
+    });
+  }
+}
+
+// ----------------------------------------------------------------------------
+// Recording
+// ----------------------------------------------------------------------------
+
+namespace {
+
+vk::DeviceSize range_end(const vk::DescriptorBufferInfo& info) {
+  return info.range == VK_WHOLE_SIZE ? std::numeric_limits<vk::DeviceSize>::max()
+                                     : info.offset + info.range;
+}
+
+bool overlaps(const vk::Buffer buffer,
+              const vk::DeviceSize begin,
+              const vk::DeviceSize end,
+              const auto& ranges) {
+  return std::ranges::any_of(ranges, [&](const auto& r) {
+    return r.buffer == buffer && begin < r.end && r.begin < end;
+  });
+}
+
+}  // namespace
+
+bool Sequence::has_hazard(const BufferRange& range, const bool read, const bool write) const {
+  // RAW, WAW, WAR
+  return untracked_pending_ ||
+         ((read || write) && overlaps(range.buffer, range.begin, range.end, pending_writes_)) ||
+         (write && overlaps(range.buffer, range.begin, range.end, pending_reads_));
+}
+
+void Sequence::track_access(const BufferRange& range, const bool read, const bool write) {
+  if (read) {
+    pending_reads_.push_back(range);
+    current().reads.push_back(range);
+  }
+  if (write) {
+    pending_writes_.push_back(range);
+    current().writes.push_back(range);
+  }
+}
+
+void Sequence::record_barrier() {
+  const vk::MemoryBarrier barrier{
+      .srcAccessMask = barrier_src_access_,
+      .dstAccessMask = barrier_dst_access_,
+  };
+
+  handle_.pipelineBarrier(barrier_stages_, barrier_stages_, {}, barrier, nullptr, nullptr);
+
+  pending_reads_.clear();
+  pending_writes_.clear();
+  untracked_pending_ = false;
+}
+
+void Sequence::record_barrier_if_needed(const Algorithm* algo) {
+  const auto& buffer_infos = algo->get_buffer_infos();
+
+  // A bindless dispatch with undeclared buffers may touch anything
+  if (algo->is_bindless() && buffer_infos.empty()) {
+    if (untracked_pending_ || !pending_reads_.empty() || !pending_writes_.empty()) {
+      spdlog::trace("Sequence: barrier before bindless [{}]", algo->get_shader_name());
+      record_barrier();
+    }
+    untracked_pending_ = true;
+    return;
+  }
+
+  const auto to_range = [](const vk::DescriptorBufferInfo& info) {
+    return BufferRange{
+        .buffer = info.buffer,
+        .begin = info.offset,
+        .end = range_end(info),
+    };
+  };
+
+  bool hazard = false;
+  for (uint32_t i = 0; i < buffer_infos.size() && !hazard; ++i) {
+    const auto access = algo->get_buffer_access(i);
+    hazard = has_hazard(to_range(buffer_infos[i]),
+                        access != BufferAccess::kWriteOnly,
+                        access != BufferAccess::kReadOnly);
+  }
+
+  if (hazard) {
+    spdlog::trace("Sequence: barrier before [{}]", algo->get_shader_name());
+    record_barrier();
+  }
+
+  for (uint32_t i = 0; i < buffer_infos.size(); ++i) {
+    const auto access = algo->get_buffer_access(i);
+    track_access(to_range(buffer_infos[i]),
+                 access != BufferAccess::kWriteOnly,
+                 access != BufferAccess::kReadOnly);
+  }
+}
+
+void Sequence::record_bind(const Algorithm* algo, const DispatchBinding* binding) {
+  if (binding) {
+    handle_.bindPipeline(vk::PipelineBindPoint::eCompute, binding->pipeline);
+    handle_.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                               binding->pipeline_layout,
+                               0,
+                               binding->descriptor_set,
+                               nullptr);
+  } else {
+    algo->record_bind_core(handle_, *current().descriptor_ring);
+  }
 
-  algo->record_bind_core(handle_);
   if (algo->has_push_constants()) {
     algo->record_bind_push(handle_);
   }
+}
+
+std::optional<uint32_t> Sequence::record_begin_timestamp() {
+  const auto& recording = current();
+  if (!timed_recording_ || recording.timed_dispatch_labels.size() >= max_timed_dispatches_) {
+    return std::nullopt;
+  }
+
+  // The begin timestamp is written once all earlier commands started
+  const auto query =
+      recording.first_query + static_cast<uint32_t>(2 * recording.timed_dispatch_labels.size());
+  handle_.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, query_pool_, query);
+  return query;
+}
+
+void Sequence::record_end_timestamp(const Algorithm* algo, const std::optional<uint32_t> query) {
+  if (query) {
+    handle_.writeTimestamp(vk::PipelineStageFlagBits::eComputeShader, query_pool_, *query + 1);
+    current().timed_dispatch_labels.push_back(algo->get_shader_name());
+  } else if (timed_recording_ && !untimed_warned_) {
+    spdlog::warn("Sequence: more than {} dispatches, [{}] and later ones are not timed",
+                 max_timed_dispatches_,
+                 algo->get_shader_name());
+    untimed_warned_ = true;
+  }
+}
+
+void Sequence::record_dispatch(const Algorithm* algo, const std::array<uint32_t, 3> grid_size) {
+  spdlog::trace("Sequence::record_dispatch()");
+  const ScopedTrace trace("Sequence::record_dispatch");
 
+  record_barrier_if_needed(algo);
+  record_bind(algo, nullptr);
+
+  const auto query = record_begin_timestamp();
   algo->record_dispatch(handle_, grid_size);
+  record_end_timestamp(algo, query);
+}
+
+void Sequence::record_dispatch_indirect(const Algorithm* algo,
+                                        const vk::DescriptorBufferInfo& indirect,
+                                        const DispatchBinding* binding) {
+  spdlog::trace("Sequence::record_dispatch_indirect()");
+  const ScopedTrace trace("Sequence::record_dispatch_indirect");
+
+  const BufferRange indirect_range{
+      .buffer = indirect.buffer,
+      .begin = indirect.offset,
+      .end = indirect.offset + sizeof(vk::DispatchIndirectCommand),
+  };
+
+  // Work group counts written by an earlier dispatch
+  if (has_hazard(indirect_range, true, false)) {
+    spdlog::trace("Sequence: barrier before indirect [{}]", algo->get_shader_name());
+    record_barrier();
+  }
+
+  record_barrier_if_needed(algo);
+  track_access(indirect_range, true, false);
+
+  record_bind(algo, binding);
+
+  const auto query = record_begin_timestamp();
+  handle_.dispatchIndirect(indirect.buffer, indirect.offset);
+  record_end_timestamp(algo, query);
+}
+
+void Sequence::record_copy(const vk::Buffer src,
+                           const vk::Buffer dst,
+                           const vk::BufferCopy& region) {
+  spdlog::trace("Sequence::record_copy() {} bytes", region.size);
+
+  const BufferRange src_range{
+      .buffer = src,
+      .begin = region.srcOffset,
+      .end = region.srcOffset + region.size,
+  };
+  const BufferRange dst_range{
+      .buffer = dst,
+      .begin = region.dstOffset,
+      .end = region.dstOffset + region.size,
+  };
+
+  if (has_hazard(src_range, true, false) || has_hazard(dst_range, false, true)) {
+    spdlog::trace("Sequence: barrier before copy");
+    record_barrier();
+  }
+
+  handle_.copyBuffer(src, dst, region);
+
+  track_access(src_range, true, false);
+  track_access(dst_range, false, true);
+}
+
+void Sequence::record_fill(const vk::Buffer dst,
+                           const vk::DeviceSize offset,
+                           const vk::DeviceSize size,
+                           const uint32_t data) {
+  spdlog::trace("Sequence::record_fill() {} bytes", size);
 
+  const BufferRange dst_range{
+      .buffer = dst,
+      .begin = offset,
+      .end = offset + size,
+  };
+
+  if (has_hazard(dst_range, false, true)) {
+    spdlog::trace("Sequence: barrier before fill");
+    record_barrier();
+  }
+
+  handle_.fillBuffer(dst, offset, size, data);
+
+  track_access(dst_range, false, true);
+}
+
+void Sequence::record_commands(const Algorithm* algo, const std::array<uint32_t, 3> grid_size) {
+  spdlog::trace("Sequence::record_commands()");
+
+  cmd_begin();
+  record_dispatch(algo, grid_size);
   cmd_end();
 }
 
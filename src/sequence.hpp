@@ -1,42 +1,289 @@
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
 #include "algorithm.hpp"
+#include "descriptor_ring.hpp"
+#include "future.hpp"
 
 namespace vulkan {
 
-class Sequence {
+// GPU time of one recorded dispatch, see 'Sequence::enable_profiling()'
+struct DispatchTiming {
+  std::string shader_name;
+
+  // Device timestamps converted to nanoseconds (arbitrary but common origin)
+  uint64_t begin_ns = 0;
+  uint64_t end_ns = 0;
+
+  [[nodiscard]] double duration_ms() const { return static_cast<double>(end_ns - begin_ns) * 1e-6; }
+};
+
+// Pipeline and descriptor set bound in place of an Algorithm's own, see 'Graph'
+struct DispatchBinding {
+  vk::Pipeline pipeline;
+  vk::PipelineLayout pipeline_layout;
+  vk::DescriptorSet descriptor_set;
+};
+
+class Sequence : public std::enable_shared_from_this<Sequence> {
  public:
+  // 'queue_flags' of the queue's family; transfer-only queues can only record copies
   explicit Sequence(vk::Device device_ref,
                     vk::Queue compute_queue_ref,
-                    uint32_t compute_queue_index);
+                    uint32_t compute_queue_index,
+                    vk::QueueFlags queue_flags = vk::QueueFlagBits::eCompute);
+
+  ~Sequence();
 
-  ~Sequence() = default;
+  Sequence(const Sequence&) = delete;
+  Sequence& operator=(const Sequence&) = delete;
 
-  void cmd_begin() const;
+  /**
+   * @brief Start a new recording
+   * @param one_time_submit 'false' keeps the recording valid for repeated
+   *                        submission, also while earlier submissions of it
+   *                        are still in flight
+   *
+   * Each recording has its own command buffer, descriptor sets and retained
+   * memory, recycled once the timeline shows its submissions completed. So
+   * recording does not wait for in-flight submissions, unless
+   * 'kMaxRecordings' of them are still pending, then it waits for the oldest.
+   */
+  void cmd_begin(bool one_time_submit = true);
   void cmd_end() const;
 
-  void record_commands(const Algorithm* algo, std::array<uint32_t, 3> grid_size) const;
-  void launch_kernel_async() const;
-  void sync() const;
+  /**
+   * @brief Append a dispatch to the command buffer being recorded
+   * @param algo Algorithm to bind, with its current buffers and push constants
+   * @param grid_size Number of work groups
+   *
+   * A compute-to-compute barrier is inserted only when this dispatch touches a
+   * buffer range that an earlier dispatch (since the last barrier) wrote, or
+   * writes a range an earlier one read. Access comes from the shader's
+   * readonly/writeonly qualifiers.
+   *
+   * The Algorithm's buffers are captured here (pushed, or written to a set of
+   * this Sequence's 'DescriptorRing'), so it can be rebound and dispatched
+   * again in the same recording.
+   *
+   * Bindless Algorithms are ordered by the buffers given to their
+   * 'update_buffer()', or fenced by barriers on both sides if none were given.
+   *
+   * Example usage:
+   * ```cpp
+   * seq->cmd_begin();
+   * seq->record_dispatch(morton.get(), {div_ceil(n, 768), 1, 1});
+   * seq->record_dispatch(sort.get(), {1, 1, 1});
+   * seq->cmd_end();
+   * seq->launch_kernel_async();
+   * seq->sync();
+   * ```
+   */
+  void record_dispatch(const Algorithm* algo, std::array<uint32_t, 3> grid_size);
+
+  /**
+   * @brief Append a dispatch whose work group count is read from memory when it runs
+   * @param indirect A 'vk::DispatchIndirectCommand' (buffers need 'eIndirectBuffer' usage);
+   *                 earlier GPU writes to it are ordered like writes to any bound buffer
+   * @param binding Pipeline and set to bind instead of the Algorithm's own, with a
+   *                layout compatible with it for push constants; null binds the Algorithm
+   */
+  void record_dispatch_indirect(const Algorithm* algo,
+                                const vk::DescriptorBufferInfo& indirect,
+                                const DispatchBinding* binding = nullptr);
+
+  // Append a buffer copy, ordered against earlier dispatches/copies like 'record_dispatch()'
+  void record_copy(vk::Buffer src, vk::Buffer dst, const vk::BufferCopy& region);
+
+  // Append a fill of 'size' bytes (a multiple of 4) with the 32-bit 'data', ordered the same way
+  void record_fill(vk::Buffer dst, vk::DeviceSize offset, vk::DeviceSize size, uint32_t data);
+
+  // Record a single dispatch: cmd_begin() + record_dispatch() + cmd_end()
+  void record_commands(const Algorithm* algo, std::array<uint32_t, 3> grid_size);
+
+  /**
+   * @brief Submit the recorded command buffer
+   * @param wait_on Submissions (of any Sequence) that must complete on the GPU
+   *                before this one starts, without a host-side wait
+   * @return Future completed when this submission finished
+   *
+   * Several submissions can be in flight at once; a recording made with
+   * 'cmd_begin(false)' may be submitted again before the previous one completed.
+   * Like a CUDA stream, each submission waits on the GPU for the previous one
+   * of this Sequence, so consecutive recordings need no host-side wait.
+   * The Future holds a weak reference to this Sequence (made by the Engine
+   * as a shared_ptr), so it stays safe to query after the Sequence is gone.
+   *
+   * Example usage:
+   * ```cpp
+   * const auto a = seq_a->launch_kernel_async();
+   * const auto b = seq_b->launch_kernel_async({&a, 1});  // GPU waits for 'a'
+   * prepare_next_batch_on_cpu();
+   * b.wait();
+   * ```
+   */
+  Future launch_kernel_async(std::span<const Future> wait_on = {});
+
+  // Wait for every submission of this Sequence
+  void sync();
+
+  // Keep memory the recording uses but does not own alive until its submissions completed
+  // and it is recycled, see 'ScratchBuffer'
+  void retain(std::shared_ptr<const void> resource);
+
+  /**
+   * @brief Keep host-mapped buffers coherent around submissions
+   *
+   * With a memory resource set, ranges the recording reads are flushed
+   * before each submit and ranges it writes are invalidated after 'sync()'
+   * or once the latest submission's Future is waited on, for buffers of
+   * 'mr_ptr' in non-coherent memory. Costs nothing when all
+   * memory is coherent.
+   */
+  void set_memory_resource(VulkanMemoryResource* mr_ptr) { mr_ptr_ = mr_ptr; }
+
+  /**
+   * @brief Time every dispatch recorded from now on with GPU timestamps
+   * @param timestamp_period Nanoseconds per tick ('BaseEngine::get_timestamp_period()')
+   * @param timestamp_valid_bits 'BaseEngine::get_timestamp_valid_bits()' of this queue family
+   * @param max_dispatches Dispatches per recording that can be timed, extra ones are not
+   * @param calibrated_timestamps Place GPU trace spans on the host clock with
+   *                              VK_EXT_calibrated_timestamps
+   *                              ('BaseEngine::supports_calibrated_timestamps()')
+   *
+   * Adds a timestamp write before and after each dispatch. Dispatches without
+   * a barrier in between may overlap on the GPU, and so may their timings.
+   * Each recording has its own query range. Only one-time recordings are
+   * timed: a 'cmd_begin(false)' recording can be in flight several times at
+   * once, and its submissions would share that range.
+   */
+  void enable_profiling(float timestamp_period,
+                        uint32_t timestamp_valid_bits,
+                        uint32_t max_dispatches = 256,
+                        bool calibrated_timestamps = false);
+
+  [[nodiscard]] bool is_profiling() const { return static_cast<bool>(query_pool_); }
+
+  // Per-dispatch timings of the latest submission, in recording order. Call after 'sync()'.
+  [[nodiscard]] std::vector<DispatchTiming> get_timings() const;
 
   [[nodiscard]] vk::CommandBuffer get_handle() const { return handle_; }
 
+  // Recordings whose submissions may be in flight at once
+  static constexpr size_t kMaxRecordings = 4;
+
  protected:
   void destroy();
 
  private:
+  friend class Future;
+
+  struct BufferRange {
+    vk::Buffer buffer;
+    vk::DeviceSize begin;
+    vk::DeviceSize end;
+  };
+
+  void record_barrier_if_needed(const Algorithm* algo);
+  void record_barrier();
+
+  void record_bind(const Algorithm* algo, const DispatchBinding* binding);
+
+  // Timestamp query index written before the dispatch, or nullopt if it is not timed
+  std::optional<uint32_t> record_begin_timestamp();
+  void record_end_timestamp(const Algorithm* algo, std::optional<uint32_t> query);
+
+  [[nodiscard]] bool has_hazard(const BufferRange& range, bool read, bool write) const;
+  void track_access(const BufferRange& range, bool read, bool write);
+
+  // Invalidates the written ranges once a Future saw the latest submission complete
+  void on_complete(uint64_t value);
+
+  /**
+   * @brief A command buffer and everything its submissions reference
+   *
+   * Recycled by 'cmd_begin()' once the timeline reached 'submitted_value'.
+   */
+  struct Recording {
+    vk::CommandBuffer handle;
+    std::unique_ptr<DescriptorRing> descriptor_ring;
+    std::vector<std::shared_ptr<const void>> retained;
+
+    // Timeline value of the latest submission, 0 if never submitted
+    uint64_t submitted_value = 0;
+
+    // Coherency, all ranges the recording reads and writes
+    std::vector<BufferRange> reads;
+    std::vector<BufferRange> writes;
+    bool invalidate_pending = false;
+
+    // Profiling, 2 timestamps per labelled dispatch from 'first_query' on
+    uint32_t first_query = 0;
+    std::vector<std::string> timed_dispatch_labels;
+    uint64_t submit_host_ns = 0;
+    bool gpu_spans_pending = false;
+  };
+
+  [[nodiscard]] Recording& current() { return recordings_[current_]; }
+
+  // A recording whose submissions completed, allocated or waited for if there is none
+  [[nodiscard]] size_t acquire_recording();
+
+  [[nodiscard]] std::vector<DispatchTiming> get_timings(const Recording& recording) const;
+
+  // Forward the timings of a completed submission to the 'Tracer'
+  void trace_gpu_spans(Recording& recording);
+
   void create_sync_objects();
   void create_command_pool();
-  void create_command_buffer();
 
   vk::Device device_ref_;
   vk::Queue compute_queue_ref_;
 
   uint32_t compute_queue_index_;
 
-  vk::CommandBuffer handle_;
+  // Stages and accesses covered by barriers, limited to what the queue supports
+  vk::PipelineStageFlags barrier_stages_;
+  vk::AccessFlags barrier_src_access_;
+  vk::AccessFlags barrier_dst_access_;
+
   vk::CommandPool command_pool_;
-  vk::Fence fence_;
+
+  // 'current_' is being recorded (or was recorded last), 'handle_' is its command buffer
+  std::vector<Recording> recordings_;
+  size_t current_ = 0;
+  vk::CommandBuffer handle_;
+
+  // Recording of the latest submission, for 'get_timings()'
+  size_t latest_submitted_ = 0;
+
+  // Signalled with 'submitted_value_' by the latest submission
+  vk::Semaphore timeline_;
+  uint64_t submitted_value_ = 0;
+
+  // Profiling, 2 timestamps per labelled dispatch
+  vk::QueryPool query_pool_;
+  uint32_t max_timed_dispatches_ = 0;
+  float timestamp_period_ = 0.0f;
+  uint64_t timestamp_mask_ = 0;
+  bool calibrated_timestamps_ = false;
+  bool timed_recording_ = false;  // profiling and a one-time recording
+  bool untimed_warned_ = false;  // dispatches over the limit, warned once per recording
+
+  // Coherency of the recordings' ranges
+  VulkanMemoryResource* mr_ptr_ = nullptr;
+
+  // Buffer ranges accessed since the last barrier of the current recording
+  std::vector<BufferRange> pending_reads_;
+  std::vector<BufferRange> pending_writes_;
+
+  // A bindless dispatch without declared buffers was recorded since the last barrier
+  bool untracked_pending_ = false;
 };
 
 }  // namespace vulkan
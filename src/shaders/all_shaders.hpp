@@ -14,22 +14,27 @@ namespace shaders {
 #include "h/cifar_sparse_conv2d_spv.h"
 #include "h/cifar_sparse_linear_spv.h"
 #include "h/cifar_sparse_maxpool_spv.h"
+#include "h/hello_vector_add_bindless_spv.h"
+#include "h/hello_vector_add_params_spv.h"
 #include "h/hello_vector_add_spv.h"
+#include "h/prim_compact_spv.h"
+#include "h/prim_gather_spv.h"
+#include "h/prim_iota_spv.h"
+#include "h/prim_merge_block_sort_spv.h"
+#include "h/prim_merge_partition_spv.h"
+#include "h/prim_merge_pass_spv.h"
+#include "h/prim_radix_copy_spv.h"
+#include "h/prim_radix_downsweep_spv.h"
+#include "h/prim_radix_histogram_spv.h"
+#include "h/prim_radix_upsweep_spv.h"
+#include "h/prim_scan_spv.h"
 #include "h/tmp_add_base_spv.h"
-#include "h/tmp_add_base_v2_16_spv.h"
-#include "h/tmp_add_base_v2_32_spv.h"
-#include "h/tmp_add_base_v2_64_spv.h"
+#include "h/tmp_add_base_v2_spv.h"
 #include "h/tmp_global_exclusive_scan_spv.h"
-#include "h/tmp_global_exclusive_scan_v2_16_spv.h"
-#include "h/tmp_global_exclusive_scan_v2_32_spv.h"
-#include "h/tmp_global_exclusive_scan_v2_64_spv.h"
+#include "h/tmp_global_exclusive_scan_v2_spv.h"
 #include "h/tmp_local_inclusive_scan_spv.h"
-#include "h/tmp_local_inclusive_scan_v2_16_spv.h"
-#include "h/tmp_local_inclusive_scan_v2_32_spv.h"
-#include "h/tmp_local_inclusive_scan_v2_64_spv.h"
-#include "h/tmp_single_radixsort_warp16_spv.h"
-#include "h/tmp_single_radixsort_warp32_spv.h"
-#include "h/tmp_single_radixsort_warp64_spv.h"
+#include "h/tmp_local_inclusive_scan_v2_spv.h"
+#include "h/tmp_single_radixsort_spv.h"
 #include "h/tree_build_octree_spv.h"
 #include "h/tree_build_radix_tree_spv.h"
 #include "h/tree_edge_count_spv.h"
@@ -56,21 +61,26 @@ static const std::unordered_map<std::string, std::pair<const unsigned char*, siz
     SHADER_ENTRY(cifar_sparse_linear),
     SHADER_ENTRY(cifar_sparse_maxpool),
     SHADER_ENTRY(hello_vector_add),
+    SHADER_ENTRY(hello_vector_add_bindless),
+    SHADER_ENTRY(hello_vector_add_params),
+    SHADER_ENTRY(prim_compact),
+    SHADER_ENTRY(prim_gather),
+    SHADER_ENTRY(prim_iota),
+    SHADER_ENTRY(prim_merge_block_sort),
+    SHADER_ENTRY(prim_merge_partition),
+    SHADER_ENTRY(prim_merge_pass),
+    SHADER_ENTRY(prim_radix_copy),
+    SHADER_ENTRY(prim_radix_downsweep),
+    SHADER_ENTRY(prim_radix_histogram),
+    SHADER_ENTRY(prim_radix_upsweep),
+    SHADER_ENTRY(prim_scan),
     SHADER_ENTRY(tmp_add_base),
-    SHADER_ENTRY(tmp_add_base_v2_16),
-    SHADER_ENTRY(tmp_add_base_v2_32),
-    SHADER_ENTRY(tmp_add_base_v2_64),
+    SHADER_ENTRY(tmp_add_base_v2),
     SHADER_ENTRY(tmp_global_exclusive_scan),
-    SHADER_ENTRY(tmp_global_exclusive_scan_v2_16),
-    SHADER_ENTRY(tmp_global_exclusive_scan_v2_32),
-    SHADER_ENTRY(tmp_global_exclusive_scan_v2_64),
+    SHADER_ENTRY(tmp_global_exclusive_scan_v2),
     SHADER_ENTRY(tmp_local_inclusive_scan),
-    SHADER_ENTRY(tmp_local_inclusive_scan_v2_16),
-    SHADER_ENTRY(tmp_local_inclusive_scan_v2_32),
-    SHADER_ENTRY(tmp_local_inclusive_scan_v2_64),
-    SHADER_ENTRY(tmp_single_radixsort_warp16),
-    SHADER_ENTRY(tmp_single_radixsort_warp32),
-    SHADER_ENTRY(tmp_single_radixsort_warp64),
+    SHADER_ENTRY(tmp_local_inclusive_scan_v2),
+    SHADER_ENTRY(tmp_single_radixsort),
     SHADER_ENTRY(tree_build_octree),
     SHADER_ENTRY(tree_build_radix_tree),
     SHADER_ENTRY(tree_edge_count),
@@ -0,0 +1,70 @@
+// Decoupled look-back (Merrill & Garland, 2016), shared by 'prim_scan' and 'prim_compact'.
+//
+// After the tile counter at [0], 'tileState' holds (flag, aggregate, inclusive
+// prefix) per tile. A tile publishes its aggregate as soon as it is known; the
+// first subgroup of its work group then looks back over the predecessors'
+// status words, WARP_SIZE tiles at a time, until it finds a published
+// inclusive prefix. Host side: 'LookbackState'.
+//
+// The including shader declares first:
+//   WARP_SIZE                  - subgroup size
+//   tileState                  - coherent buffer of status words, zeroed before each pass
+//   uint combine(uint, uint)   - the associative operator of the prefix
+//   uint subgroupCombine(uint) - its subgroup reduction
+
+// Next tile for the calling work group, claimed by one of its invocations.
+// Tiles are numbered in the order work groups claim them, so every tile a
+// work group waits on in 'lookBack()' belongs to a work group that is already
+// running. Work groups claim tiles until they run out, so the grid may be
+// smaller than the number of tiles.
+uint claimTile() {
+    return atomicAdd(tileState.data[0], 1);
+}
+
+// Tile status flags
+#define FLAG_NONE 0u
+#define FLAG_AGGREGATE 1u
+#define FLAG_PREFIX 2u
+
+void publish(uint tile, uint flag, uint value) {
+    const uint slot = 1 + 3 * tile;
+    tileState.data[slot + flag] = value;
+    memoryBarrierBuffer();
+    atomicExchange(tileState.data[slot], flag);
+}
+
+// Combined value of all tiles before 'tile' (> 0), called by every lane of one subgroup.
+// Lane i inspects tile (windowEnd - i).
+uint lookBack(uint tile, uint laneID) {
+    uint exclusive = 0;
+    int windowEnd = int(tile) - 1;
+
+    while (true) {
+        const int predecessor = windowEnd - int(laneID);
+
+        // Lanes before tile 0 act as an empty prefix
+        uint flag = FLAG_PREFIX;
+        uint value = 0;
+        if (predecessor >= 0) {
+            const uint slot = 1 + 3 * uint(predecessor);
+            do {
+                flag = atomicOr(tileState.data[slot], 0);
+            } while (flag == FLAG_NONE);
+            memoryBarrierBuffer();
+            value = tileState.data[slot + flag];
+        }
+
+        // The nearest predecessor with a prefix ends the look-back
+        const uvec4 prefixLanes = subgroupBallot(flag == FLAG_PREFIX);
+        if (subgroupBallotBitCount(prefixLanes) > 0) {
+            const uint nearest = subgroupBallotFindLSB(prefixLanes);
+            exclusive = combine(exclusive, subgroupCombine(laneID <= nearest ? value : 0));
+            break;
+        }
+
+        exclusive = combine(exclusive, subgroupCombine(value));
+        windowEnd -= int(WARP_SIZE);
+    }
+
+    return exclusive;
+}
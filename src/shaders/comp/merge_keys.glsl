@@ -0,0 +1,36 @@
+// Key order of the merge sort, shared by the 'prim_merge_*' shaders.
+//
+// Keys are held as (lo, hi) words; only 64-bit keys use the high word. Ties
+// are left to the caller, which breaks them by position to stay stable.
+//
+// The including shader declares first:
+//   KEY_TYPE   - 0 = uint, 1 = int, 2 = float, 3 = uint64 (lo, hi words)
+//   KEY_WORDS  - 32-bit words per key in memory (2 for uint64, else 1)
+//   DESCENDING - reverse the order
+//   srcKeys    - buffer of the keys being sorted
+
+bool keyLess(uvec2 a, uvec2 b) {
+    if (DESCENDING) {
+        const uvec2 t = a;
+        a = b;
+        b = t;
+    }
+    if (KEY_TYPE == 1) {
+        return int(a.x) < int(b.x);
+    }
+    if (KEY_TYPE == 2) {
+        return uintBitsToFloat(a.x) < uintBitsToFloat(b.x);
+    }
+    if (KEY_TYPE == 3) {
+        return a.y < b.y || (a.y == b.y && a.x < b.x);
+    }
+    return a.x < b.x;
+}
+
+uvec2 loadKey(uint index) {
+    uvec2 key = uvec2(srcKeys.data[index * KEY_WORDS], 0);
+    if (KEY_WORDS == 2) {
+        key.y = srcKeys.data[index * KEY_WORDS + 1];
+    }
+    return key;
+}
@@ -0,0 +1,504 @@
+#include "spirv_reflect.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+namespace vulkan {
+
+namespace {
+
+// Subset of the SPIR-V spec we care about
+// https://registry.khronos.org/SPIR-V/specs/unified1/SPIRV.html
+namespace spv {
+
+constexpr uint32_t kMagic = 0x07230203;
+constexpr size_t kHeaderWords = 5;
+
+enum Op : uint32_t {
+  OpName = 5,
+  OpExecutionMode = 16,
+  OpTypeBool = 20,
+  OpTypeInt = 21,
+  OpTypeFloat = 22,
+  OpTypeVector = 23,
+  OpTypeMatrix = 24,
+  OpTypeArray = 28,
+  OpTypeRuntimeArray = 29,
+  OpTypeStruct = 30,
+  OpTypePointer = 32,
+  OpConstant = 43,
+  OpConstantComposite = 44,
+  OpSpecConstantTrue = 48,
+  OpSpecConstantFalse = 49,
+  OpSpecConstant = 50,
+  OpSpecConstantComposite = 51,
+  OpVariable = 59,
+  OpDecorate = 71,
+  OpMemberDecorate = 72,
+  OpExecutionModeId = 331,
+};
+
+enum Decoration : uint32_t {
+  DecorationSpecId = 1,
+  DecorationBlock = 2,
+  DecorationBufferBlock = 3,
+  DecorationArrayStride = 6,
+  DecorationMatrixStride = 7,
+  DecorationBuiltIn = 11,
+  DecorationNonWritable = 24,
+  DecorationNonReadable = 25,
+  DecorationBinding = 33,
+  DecorationDescriptorSet = 34,
+  DecorationOffset = 35,
+};
+
+enum StorageClass : uint32_t {
+  StorageClassUniform = 2,
+  StorageClassPushConstant = 9,
+  StorageClassStorageBuffer = 12,
+  StorageClassPhysicalStorageBuffer = 5349,
+};
+
+constexpr uint32_t kExecutionModeLocalSize = 17;
+constexpr uint32_t kExecutionModeLocalSizeId = 38;
+constexpr uint32_t kBuiltInWorkgroupSize = 25;
+
+}  // namespace spv
+
+struct Decorations {
+  std::optional<uint32_t> binding;
+  std::optional<uint32_t> set;
+  std::optional<uint32_t> builtin;
+  std::optional<uint32_t> array_stride;
+  std::optional<uint32_t> spec_id;
+  bool block = false;
+  bool buffer_block = false;
+  bool non_writable = false;
+  bool non_readable = false;
+};
+
+struct MemberDecorations {
+  std::optional<uint32_t> offset;
+  std::optional<uint32_t> matrix_stride;
+  bool non_writable = false;
+  bool non_readable = false;
+};
+
+struct Type {
+  uint32_t op = 0;
+  std::vector<uint32_t> operands;  // everything after the result id
+};
+
+struct Variable {
+  uint32_t id = 0;
+  uint32_t pointer_type = 0;
+  uint32_t storage_class = 0;
+};
+
+class Parser {
+ public:
+  explicit Parser(const std::span<const uint32_t> spirv) : spirv_(spirv) {}
+
+  ShaderReflection run() {
+    parse();
+
+    ShaderReflection reflection;
+    reflect_bindings(reflection);
+    reflect_push_constants(reflection);
+    reflect_local_size(reflection);
+    reflect_spec_constants(reflection);
+    return reflection;
+  }
+
+ private:
+  void parse() {
+    if (spirv_.size() < spv::kHeaderWords || spirv_[0] != spv::kMagic) {
+      throw std::runtime_error("Invalid SPIR-V module");
+    }
+
+    size_t pos = spv::kHeaderWords;
+    while (pos < spirv_.size()) {
+      const uint32_t word_count = spirv_[pos] >> 16;
+      const uint32_t opcode = spirv_[pos] & 0xffff;
+
+      if (word_count == 0 || pos + word_count > spirv_.size()) {
+        throw std::runtime_error("Malformed SPIR-V instruction");
+      }
+
+      parse_instruction(opcode, spirv_.subspan(pos + 1, word_count - 1));
+      pos += word_count;
+    }
+  }
+
+  void parse_instruction(const uint32_t opcode, const std::span<const uint32_t> ops) {
+    switch (opcode) {
+      case spv::OpName:
+        names_[ops[0]] = read_string(ops.subspan(1));
+        break;
+
+      case spv::OpExecutionMode:
+        if (ops[1] == spv::kExecutionModeLocalSize) {
+          local_size_ = {ops[2], ops[3], ops[4]};
+        }
+        break;
+
+      case spv::OpExecutionModeId:
+        if (ops[1] == spv::kExecutionModeLocalSizeId) {
+          local_size_ids_ = {ops[2], ops[3], ops[4]};
+        }
+        break;
+
+      case spv::OpDecorate:
+        apply_decoration(decorations_[ops[0]], ops[1], ops.subspan(2));
+        break;
+
+      case spv::OpMemberDecorate: {
+        auto& members = member_decorations_[ops[0]];
+        if (members.size() <= ops[1]) {
+          members.resize(ops[1] + 1);
+        }
+        apply_member_decoration(members[ops[1]], ops[2], ops.subspan(3));
+        break;
+      }
+
+      case spv::OpTypeBool:
+      case spv::OpTypeInt:
+      case spv::OpTypeFloat:
+      case spv::OpTypeVector:
+      case spv::OpTypeMatrix:
+      case spv::OpTypeArray:
+      case spv::OpTypeRuntimeArray:
+      case spv::OpTypeStruct:
+      case spv::OpTypePointer:
+        types_[ops[0]] = Type{opcode, {ops.begin() + 1, ops.end()}};
+        break;
+
+      case spv::OpConstant:
+        // [result type, result id, value...], we only need the low word
+        constants_[ops[1]] = ops.size() > 2 ? ops[2] : 0;
+        break;
+
+      case spv::OpSpecConstant:
+        constants_[ops[1]] = ops.size() > 2 ? ops[2] : 0;
+        spec_constants_.push_back(ops[1]);
+        break;
+
+      case spv::OpSpecConstantTrue:
+      case spv::OpSpecConstantFalse:
+        constants_[ops[1]] = opcode == spv::OpSpecConstantTrue ? 1 : 0;
+        spec_constants_.push_back(ops[1]);
+        break;
+
+      case spv::OpConstantComposite:
+      case spv::OpSpecConstantComposite:
+        composites_[ops[1]] = {ops.begin() + 2, ops.end()};
+        break;
+
+      case spv::OpVariable:
+        variables_.push_back(Variable{
+            .id = ops[1],
+            .pointer_type = ops[0],
+            .storage_class = ops[2],
+        });
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  static std::string read_string(const std::span<const uint32_t> words) {
+    std::string str;
+    for (const auto word : words) {
+      for (int i = 0; i < 4; ++i) {
+        const char c = static_cast<char>((word >> (8 * i)) & 0xff);
+        if (c == '\0') {
+          return str;
+        }
+        str.push_back(c);
+      }
+    }
+    return str;
+  }
+
+  static void apply_decoration(Decorations& deco,
+                               const uint32_t decoration,
+                               const std::span<const uint32_t> literals) {
+    switch (decoration) {
+      case spv::DecorationSpecId:
+        deco.spec_id = literals[0];
+        break;
+      case spv::DecorationBlock:
+        deco.block = true;
+        break;
+      case spv::DecorationBufferBlock:
+        deco.buffer_block = true;
+        break;
+      case spv::DecorationArrayStride:
+        deco.array_stride = literals[0];
+        break;
+      case spv::DecorationBuiltIn:
+        deco.builtin = literals[0];
+        break;
+      case spv::DecorationNonWritable:
+        deco.non_writable = true;
+        break;
+      case spv::DecorationNonReadable:
+        deco.non_readable = true;
+        break;
+      case spv::DecorationBinding:
+        deco.binding = literals[0];
+        break;
+      case spv::DecorationDescriptorSet:
+        deco.set = literals[0];
+        break;
+      default:
+        break;
+    }
+  }
+
+  static void apply_member_decoration(MemberDecorations& deco,
+                                      const uint32_t decoration,
+                                      const std::span<const uint32_t> literals) {
+    switch (decoration) {
+      case spv::DecorationOffset:
+        deco.offset = literals[0];
+        break;
+      case spv::DecorationMatrixStride:
+        deco.matrix_stride = literals[0];
+        break;
+      case spv::DecorationNonWritable:
+        deco.non_writable = true;
+        break;
+      case spv::DecorationNonReadable:
+        deco.non_readable = true;
+        break;
+      default:
+        break;
+    }
+  }
+
+  [[nodiscard]] const Type& type(const uint32_t id) const {
+    const auto it = types_.find(id);
+    if (it == types_.end()) {
+      throw std::runtime_error("SPIR-V references unknown type %" + std::to_string(id));
+    }
+    return it->second;
+  }
+
+  [[nodiscard]] uint32_t constant(const uint32_t id) const {
+    const auto it = constants_.find(id);
+    if (it == constants_.end()) {
+      throw std::runtime_error("SPIR-V references unknown constant %" + std::to_string(id));
+    }
+    return it->second;
+  }
+
+  [[nodiscard]] const Decorations* find_decorations(const uint32_t id) const {
+    const auto it = decorations_.find(id);
+    return it == decorations_.end() ? nullptr : &it->second;
+  }
+
+  [[nodiscard]] const std::vector<MemberDecorations>* find_member_decorations(
+      const uint32_t id) const {
+    const auto it = member_decorations_.find(id);
+    return it == member_decorations_.end() ? nullptr : &it->second;
+  }
+
+  [[nodiscard]] std::string name_of(const uint32_t id) const {
+    const auto it = names_.find(id);
+    return it == names_.end() ? std::string{} : it->second;
+  }
+
+  // Size in bytes of a type laid out with explicit offsets/strides (std430 / push constants)
+  [[nodiscard]] size_t size_of(const uint32_t id) const {
+    const auto& t = type(id);
+
+    switch (t.op) {
+      case spv::OpTypeBool:
+        return 4;
+      case spv::OpTypeInt:
+      case spv::OpTypeFloat:
+        return t.operands[0] / 8;
+      case spv::OpTypeVector:
+        return t.operands[1] * size_of(t.operands[0]);
+      case spv::OpTypeMatrix:
+        return t.operands[1] * size_of(t.operands[0]);
+      case spv::OpTypeArray: {
+        const auto* deco = find_decorations(id);
+        const size_t stride =
+            (deco && deco->array_stride) ? *deco->array_stride : size_of(t.operands[0]);
+        return constant(t.operands[1]) * stride;
+      }
+      case spv::OpTypeRuntimeArray:
+        return 0;
+      case spv::OpTypeStruct:
+        return struct_size(id);
+      case spv::OpTypePointer:
+        // Only physical storage buffer pointers have a size (buffer device address)
+        return t.operands[0] == spv::StorageClassPhysicalStorageBuffer ? 8 : 0;
+      default:
+        throw std::runtime_error("SPIR-V type with unsupported size");
+    }
+  }
+
+  [[nodiscard]] size_t struct_size(const uint32_t id) const {
+    const auto& t = type(id);
+    const auto* members = find_member_decorations(id);
+
+    size_t size = 0;
+    size_t running_offset = 0;
+    for (size_t i = 0; i < t.operands.size(); ++i) {
+      size_t offset = running_offset;
+      size_t member_size = size_of(t.operands[i]);
+
+      if (members && i < members->size()) {
+        const auto& deco = (*members)[i];
+        if (deco.offset) {
+          offset = *deco.offset;
+        }
+        if (deco.matrix_stride && type(t.operands[i]).op == spv::OpTypeMatrix) {
+          member_size = type(t.operands[i]).operands[1] * size_t{*deco.matrix_stride};
+        }
+      }
+
+      running_offset = offset + member_size;
+      size = std::max(size, running_offset);
+    }
+    return size;
+  }
+
+  void reflect_bindings(ShaderReflection& reflection) const {
+    for (const auto& var : variables_) {
+      if (var.storage_class != spv::StorageClassStorageBuffer &&
+          var.storage_class != spv::StorageClassUniform) {
+        continue;
+      }
+
+      const auto* var_deco = find_decorations(var.id);
+      if (!var_deco || !var_deco->binding) {
+        continue;
+      }
+
+      // Pointer -> (array of)? block struct
+      uint32_t block_id = type(var.pointer_type).operands[1];
+      uint32_t count = 1;
+      if (const auto& t = type(block_id); t.op == spv::OpTypeArray) {
+        count = constant(t.operands[1]);
+        block_id = t.operands[0];
+      }
+
+      const auto* block_deco = find_decorations(block_id);
+      const bool is_storage = var.storage_class == spv::StorageClassStorageBuffer ||
+                              (block_deco && block_deco->buffer_block);
+
+      // 'readonly'/'writeonly' is either on the variable or on every block member
+      bool non_writable = var_deco->non_writable;
+      bool non_readable = var_deco->non_readable;
+      if (const auto* members = find_member_decorations(block_id);
+          members && !members->empty()) {
+        non_writable |= std::ranges::all_of(*members, [](const auto& m) { return m.non_writable; });
+        non_readable |= std::ranges::all_of(*members, [](const auto& m) { return m.non_readable; });
+      }
+
+      auto access = BufferAccess::kReadWrite;
+      if (non_writable) {
+        access = BufferAccess::kReadOnly;
+      } else if (non_readable) {
+        access = BufferAccess::kWriteOnly;
+      }
+
+      auto name = name_of(var.id);
+      if (name.empty()) {
+        name = name_of(block_id);
+      }
+
+      reflection.bindings.push_back(ReflectedBinding{
+          .set = var_deco->set.value_or(0),
+          .binding = *var_deco->binding,
+          .count = count,
+          .type = is_storage ? vk::DescriptorType::eStorageBuffer
+                             : vk::DescriptorType::eUniformBuffer,
+          .access = access,
+          .name = std::move(name),
+      });
+    }
+
+    std::ranges::sort(reflection.bindings, [](const auto& a, const auto& b) {
+      return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+    });
+  }
+
+  void reflect_push_constants(ShaderReflection& reflection) const {
+    for (const auto& var : variables_) {
+      if (var.storage_class == spv::StorageClassPushConstant) {
+        reflection.push_constant_size = size_of(type(var.pointer_type).operands[1]);
+      }
+    }
+  }
+
+  void reflect_local_size(ShaderReflection& reflection) const {
+    reflection.local_size = local_size_;
+
+    const auto apply_ids = [&](const std::span<const uint32_t> ids) {
+      for (size_t i = 0; i < 3; ++i) {
+        reflection.local_size[i] = constant(ids[i]);
+        if (const auto* deco = find_decorations(ids[i]); deco && deco->spec_id) {
+          reflection.local_size_spec_ids[i] = *deco->spec_id;
+        }
+      }
+    };
+
+    if (local_size_ids_) {
+      apply_ids(*local_size_ids_);
+    }
+
+    // A 'WorkgroupSize' built-in constant takes precedence over the execution mode
+    for (const auto& [id, deco] : decorations_) {
+      if (deco.builtin == spv::kBuiltInWorkgroupSize && composites_.contains(id)) {
+        apply_ids(composites_.at(id));
+      }
+    }
+  }
+
+  void reflect_spec_constants(ShaderReflection& reflection) const {
+    for (const auto id : spec_constants_) {
+      const auto* deco = find_decorations(id);
+      if (!deco || !deco->spec_id) {
+        continue;
+      }
+
+      reflection.spec_constants.push_back(ReflectedSpecConstant{
+          .id = *deco->spec_id,
+          .default_value = constant(id),
+      });
+    }
+
+    std::ranges::sort(reflection.spec_constants, {}, &ReflectedSpecConstant::id);
+  }
+
+  std::span<const uint32_t> spirv_;
+
+  std::unordered_map<uint32_t, std::string> names_;
+  std::unordered_map<uint32_t, Decorations> decorations_;
+  std::unordered_map<uint32_t, std::vector<MemberDecorations>> member_decorations_;
+  std::unordered_map<uint32_t, Type> types_;
+  std::unordered_map<uint32_t, uint32_t> constants_;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> composites_;
+  std::vector<uint32_t> spec_constants_;
+  std::vector<Variable> variables_;
+
+  std::array<uint32_t, 3> local_size_ = {1, 1, 1};
+  std::optional<std::array<uint32_t, 3>> local_size_ids_;
+};
+
+}  // namespace
+
+ShaderReflection reflect_spirv(const std::span<const uint32_t> spirv) {
+  return Parser(spirv).run();
+}
+
+}  // namespace vulkan
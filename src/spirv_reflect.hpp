@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "vk.hpp"
+
+namespace vulkan {
+
+// How a compute shader accesses a bound buffer ('readonly'/'writeonly' in GLSL)
+enum class BufferAccess : uint8_t {
+  kReadWrite,
+  kReadOnly,
+  kWriteOnly,
+};
+
+struct ReflectedBinding {
+  uint32_t set = 0;
+  uint32_t binding = 0;
+  uint32_t count = 1;
+  vk::DescriptorType type = vk::DescriptorType::eStorageBuffer;
+  BufferAccess access = BufferAccess::kReadWrite;
+  std::string name;
+};
+
+// 'layout(constant_id = N) const T NAME = default;' (scalars are 32-bit in our shaders)
+struct ReflectedSpecConstant {
+  uint32_t id = 0;
+  uint32_t default_value = 0;
+};
+
+struct ShaderReflection {
+  // Sorted by (set, binding)
+  std::vector<ReflectedBinding> bindings;
+
+  // Size of the push constant block in bytes, 0 if the shader has none
+  size_t push_constant_size = 0;
+
+  // 'layout(local_size_x = ...)' of the entry point (default values if specialized)
+  std::array<uint32_t, 3> local_size = {1, 1, 1};
+
+  // Specialization constant id of each 'local_size_*_id' dimension, if any
+  std::array<std::optional<uint32_t>, 3> local_size_spec_ids;
+
+  // Sorted by id
+  std::vector<ReflectedSpecConstant> spec_constants;
+};
+
+/**
+ * @brief Extract bindings, push constants, local size and specialization constants from SPIR-V
+ * @param spirv SPIR-V words
+ * @return Reflection data of the (single) compute entry point
+ *
+ * This is a small, dependency-free parser covering what our compute shaders
+ * use. It throws on a malformed module.
+ */
+[[nodiscard]] ShaderReflection reflect_spirv(std::span<const uint32_t> spirv);
+
+}  // namespace vulkan
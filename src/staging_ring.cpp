@@ -0,0 +1,157 @@
+#include "staging_ring.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "tracer.hpp"
+#include "vma_pmr.hpp"
+
+extern VmaAllocator g_vma_allocator;
+
+namespace vulkan {
+
+StagingRing::StagingRing(std::shared_ptr<Sequence> seq_a,
+                         std::shared_ptr<Sequence> seq_b,
+                         const std::vector<uint32_t>& queue_family_indices,
+                         const vk::DeviceSize size)
+    : seqs_{std::move(seq_a), std::move(seq_b)}, half_size_(size / 2) {
+  if (half_size_ == 0) {
+    throw std::runtime_error("Staging ring is too small");
+  }
+
+  const auto buffer_create_info = make_buffer_create_info(
+      2 * half_size_,
+      vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
+      queue_family_indices);
+
+  // Random access so downloads read from cached memory where available
+  VmaAllocationCreateInfo alloc_create_info{};
+  alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+  alloc_create_info.flags =
+      VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo alloc_info{};
+  const auto result =
+      vmaCreateBuffer(g_vma_allocator,
+                      reinterpret_cast<const VkBufferCreateInfo*>(&buffer_create_info),
+                      &alloc_create_info,
+                      &buffer_,
+                      &allocation_,
+                      &alloc_info);
+
+  if (result != VK_SUCCESS) {
+    throw std::runtime_error("Failed to create staging buffer");
+  }
+
+  mapped_ = static_cast<std::byte*>(alloc_info.pMappedData);
+
+  spdlog::debug("StagingRing created, {} bytes", 2 * half_size_);
+}
+
+StagingRing::~StagingRing() {
+  for (const auto& seq : seqs_) {
+    seq->sync();
+  }
+
+  vmaDestroyBuffer(g_vma_allocator, buffer_, allocation_);
+}
+
+Future StagingRing::upload_async(const void* src,
+                                 const vk::Buffer dst,
+                                 const vk::DeviceSize dst_offset,
+                                 const vk::DeviceSize bytes,
+                                 std::span<const Future> wait_on) {
+  spdlog::trace("StagingRing::upload_async() {} bytes", bytes);
+  const ScopedTrace trace("StagingRing::upload");
+
+  Future last;
+
+  for (vk::DeviceSize done = 0; done < bytes;) {
+    const auto chunk = std::min(half_size_, bytes - done);
+    const auto half_offset = next_half_ * half_size_;
+    auto& seq = *seqs_[next_half_];
+
+    // The previous copy out of this half may still read it
+    seq.sync();
+    seq.cmd_begin();
+
+    std::memcpy(mapped_ + half_offset, static_cast<const std::byte*>(src) + done, chunk);
+    if (vmaFlushAllocation(g_vma_allocator, allocation_, half_offset, chunk) != VK_SUCCESS) {
+      throw std::runtime_error("Failed to flush staging buffer");
+    }
+
+    seq.record_copy(buffer_,
+                    dst,
+                    vk::BufferCopy{
+                        .srcOffset = half_offset,
+                        .dstOffset = dst_offset + done,
+                        .size = chunk,
+                    });
+    seq.cmd_end();
+
+    last = seq.launch_kernel_async(done == 0 ? wait_on : std::span<const Future>{});
+
+    done += chunk;
+    next_half_ ^= 1;
+  }
+
+  return last;
+}
+
+void StagingRing::download(const vk::Buffer src,
+                           const vk::DeviceSize src_offset,
+                           void* dst,
+                           const vk::DeviceSize bytes,
+                           std::span<const Future> wait_on) {
+  spdlog::trace("StagingRing::download() {} bytes", bytes);
+  const ScopedTrace trace("StagingRing::download");
+
+  const auto submit = [&](const vk::DeviceSize done, const size_t half) {
+    auto& seq = *seqs_[half];
+
+    // The previous copy into this half was already waited for and read out
+    seq.cmd_begin();
+    seq.record_copy(src,
+                    buffer_,
+                    vk::BufferCopy{
+                        .srcOffset = src_offset + done,
+                        .dstOffset = half * half_size_,
+                        .size = std::min(half_size_, bytes - done),
+                    });
+    seq.cmd_end();
+
+    return seq.launch_kernel_async(done == 0 ? wait_on : std::span<const Future>{});
+  };
+
+  if (bytes == 0) {
+    return;
+  }
+
+  Future pending = submit(0, next_half_);
+
+  for (vk::DeviceSize done = 0; done < bytes;) {
+    const auto chunk = std::min(half_size_, bytes - done);
+    const auto half_offset = next_half_ * half_size_;
+    next_half_ ^= 1;
+
+    // The GPU copies the next chunk into the other half while this one is read out
+    Future next;
+    if (done + chunk < bytes) {
+      next = submit(done + chunk, next_half_);
+    }
+
+    pending.wait();
+
+    if (vmaInvalidateAllocation(g_vma_allocator, allocation_, half_offset, chunk) != VK_SUCCESS) {
+      throw std::runtime_error("Failed to invalidate staging buffer");
+    }
+    std::memcpy(static_cast<std::byte*>(dst) + done, mapped_ + half_offset, chunk);
+
+    pending = next;
+    done += chunk;
+  }
+}
+
+}  // namespace vulkan
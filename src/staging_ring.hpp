@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vk_mem_alloc.h>
+
+#include <array>
+#include <memory>
+#include <span>
+
+#include "future.hpp"
+#include "sequence.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// StagingRing
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Host-visible staging memory plus the copies in and out of device-local buffers
+ *
+ * The ring is split in two halves, each with its own Sequence, so copying a
+ * chunk into one half on the host overlaps with the GPU copying the other
+ * half. Transfers larger than half the ring are chunked.
+ *
+ * Not thread safe, use one ring per thread.
+ *
+ * Example usage:
+ * ```cpp
+ * auto points = engine.make_device_buffer(n * sizeof(glm::vec4));
+ * const auto uploaded = engine.get_staging().upload_async(
+ *     host_points.data(), points->get_handle(), 0, n * sizeof(glm::vec4));
+ * seq->launch_kernel_async({&uploaded, 1});  // GPU-side dependency, no host wait
+ * ```
+ */
+class StagingRing {
+ public:
+  // Both sequences should be on the same queue, usually the transfer queue
+  explicit StagingRing(std::shared_ptr<Sequence> seq_a,
+                       std::shared_ptr<Sequence> seq_b,
+                       const std::vector<uint32_t>& queue_family_indices,
+                       vk::DeviceSize size = 64ull << 20);
+
+  ~StagingRing();
+
+  StagingRing(const StagingRing&) = delete;
+  StagingRing& operator=(const StagingRing&) = delete;
+
+  /**
+   * @brief Copy host memory into a buffer
+   * @param wait_on GPU work the first copy waits for, e.g. readers of the old contents
+   * @return Future of the last chunk; it completes after all earlier chunks
+   *
+   * Returns once the source has been copied into staging memory, so 'src' can
+   * be reused immediately.
+   */
+  Future upload_async(const void* src,
+                      vk::Buffer dst,
+                      vk::DeviceSize dst_offset,
+                      vk::DeviceSize bytes,
+                      std::span<const Future> wait_on = {});
+
+  void upload(const void* src, vk::Buffer dst, vk::DeviceSize dst_offset, vk::DeviceSize bytes) {
+    upload_async(src, dst, dst_offset, bytes).wait();
+  }
+
+  // Copy a buffer range to host memory, blocks until the data arrived
+  void download(vk::Buffer src,
+                vk::DeviceSize src_offset,
+                void* dst,
+                vk::DeviceSize bytes,
+                std::span<const Future> wait_on = {});
+
+  [[nodiscard]] vk::DeviceSize size() const { return 2 * half_size_; }
+
+ private:
+  std::array<std::shared_ptr<Sequence>, 2> seqs_;
+  size_t next_half_ = 0;
+
+  vk::DeviceSize half_size_;
+  VkBuffer buffer_ = VK_NULL_HANDLE;
+  VmaAllocation allocation_ = VK_NULL_HANDLE;
+  std::byte* mapped_ = nullptr;
+};
+
+}  // namespace vulkan
@@ -0,0 +1,175 @@
+#include "tracer.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace vulkan {
+
+namespace {
+
+void write_json_string(std::ofstream& out, const std::string& str) {
+  out << '"';
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\r':
+        out << "\\r";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        // Other control characters are not allowed raw in JSON strings
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+          out << escaped;
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+}  // namespace
+
+Tracer& Tracer::instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+void Tracer::enable(const size_t capacity) {
+  if (capacity == 0) {
+    throw std::runtime_error("Tracer capacity is 0");
+  }
+
+  std::lock_guard lock(mutex_);
+
+  ring_.clear();
+  ring_.resize(capacity);
+  next_ = 0;
+  wrapped_ = false;
+  metadata_.clear();
+  epoch_ns_.store(steady_now_ns(), std::memory_order_relaxed);
+
+  enabled_.store(true, std::memory_order_relaxed);
+  spdlog::debug("Tracer enabled ({} events)", capacity);
+}
+
+void Tracer::disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+int64_t Tracer::steady_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t Tracer::now_ns() const { return from_steady_ns(steady_now_ns()); }
+
+uint64_t Tracer::from_steady_ns(const int64_t steady_ns) const {
+  // Readings from before 'enable()' would wrap around
+  return static_cast<uint64_t>(
+      std::max<int64_t>(steady_ns - epoch_ns_.load(std::memory_order_relaxed), 0));
+}
+
+void Tracer::set_metadata(const std::string& key, std::string value) {
+  std::lock_guard lock(mutex_);
+  metadata_[key] = std::move(value);
+}
+
+uint32_t Tracer::current_thread_id() {
+  static std::atomic<uint32_t> next_id = 1;
+  thread_local const uint32_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+  return id;
+}
+
+void Tracer::record(TraceEvent event) {
+  // Began in the time base of an earlier 'enable()'
+  if (event.end_ns < event.begin_ns) {
+    return;
+  }
+
+  std::lock_guard lock(mutex_);
+
+  if (ring_.empty()) {
+    return;
+  }
+
+  ring_[next_] = std::move(event);
+  if (++next_ == ring_.size()) {
+    next_ = 0;
+    wrapped_ = true;
+  }
+}
+
+std::vector<TraceEvent> Tracer::snapshot() const {
+  std::lock_guard lock(mutex_);
+
+  std::vector<TraceEvent> events;
+  if (wrapped_) {
+    events.assign(ring_.begin() + static_cast<ptrdiff_t>(next_), ring_.end());
+  }
+  events.insert(events.end(), ring_.begin(), ring_.begin() + static_cast<ptrdiff_t>(next_));
+  return events;
+}
+
+void Tracer::write_chrome_trace(const std::string& file_path) const {
+  const auto events = snapshot();
+
+  std::map<std::string, std::string> metadata;
+  {
+    std::lock_guard lock(mutex_);
+    metadata = metadata_;
+  }
+
+  std::ofstream out(file_path);
+  if (!out) {
+    throw std::runtime_error("Failed to open trace file " + file_path);
+  }
+
+  // 'X' (complete) events, timestamps in microseconds. Device spans get their own process.
+  out << std::fixed << std::setprecision(3);
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  out << R"({"ph":"M","name":"process_name","pid":1,"args":{"name":"host"}},)" << '\n';
+  out << R"({"ph":"M","name":"process_name","pid":2,"args":{"name":"gpu"}})";
+
+  for (const auto& e : events) {
+    const bool device = e.thread_id == 0;
+
+    out << ",\n{\"ph\":\"X\",\"name\":";
+    write_json_string(out, e.name);
+    out << ",\"cat\":\"" << e.category << "\""
+        << ",\"ts\":" << static_cast<double>(e.begin_ns) * 1e-3
+        << ",\"dur\":" << static_cast<double>(e.end_ns - e.begin_ns) * 1e-3
+        << ",\"pid\":" << (device ? 2 : 1) << ",\"tid\":" << e.thread_id << "}";
+  }
+
+  out << "\n],\"metadata\":{";
+  for (auto it = metadata.begin(); it != metadata.end(); ++it) {
+    if (it != metadata.begin()) {
+      out << ',';
+    }
+    write_json_string(out, it->first);
+    out << ':';
+    write_json_string(out, it->second);
+  }
+  out << "}}\n";
+
+  spdlog::info("Wrote {} trace events to {}", events.size(), file_path);
+}
+
+}  // namespace vulkan
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// Tracer
+// ----------------------------------------------------------------------------
+
+struct TraceEvent {
+  std::string name;
+  const char* category = "host";
+
+  // Nanoseconds since the tracer was enabled
+  uint64_t begin_ns = 0;
+  uint64_t end_ns = 0;
+
+  // Host thread, or 0 for device spans
+  uint32_t thread_id = 0;
+};
+
+/**
+ * @brief Process-wide span recorder with Chrome trace (Perfetto) JSON export
+ *
+ * Disabled by default, in which case a span costs one atomic load. When
+ * enabled, spans go into a fixed-size ring buffer that keeps the most recent
+ * events. Host spans are recorded by the engine (Algorithm build, buffer
+ * updates, recording, submit, sync); GPU spans come from profiled Sequences
+ * (see 'Sequence::enable_profiling()'). The "gpu_clock" metadata entry says
+ * whether GPU spans were calibrated against the host clock.
+ *
+ * Example usage:
+ * ```cpp
+ * vulkan::Tracer::instance().enable();
+ * run_pipeline();
+ * vulkan::Tracer::instance().write_chrome_trace("trace.json");  // open in ui.perfetto.dev
+ * ```
+ */
+class Tracer {
+ public:
+  static Tracer& instance();
+
+  void enable(size_t capacity = 1 << 16);
+  void disable();
+
+  [[nodiscard]] bool is_enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Current host time in the tracer's time base
+  [[nodiscard]] uint64_t now_ns() const;
+
+  // A 'std::chrono::steady_clock' reading (ns since its epoch) in the tracer's time base,
+  // readings from before 'enable()' are clamped to 0
+  [[nodiscard]] uint64_t from_steady_ns(int64_t steady_ns) const;
+
+  // Key/value written to the trace's "metadata" object, cleared by 'enable()'
+  void set_metadata(const std::string& key, std::string value);
+
+  // Spans that end before they begin (started before a re-'enable()') are dropped
+  void record(TraceEvent event);
+
+  // Events currently held, oldest first
+  [[nodiscard]] std::vector<TraceEvent> snapshot() const;
+
+  void write_chrome_trace(const std::string& file_path) const;
+
+  // Small, stable id of the calling thread
+  [[nodiscard]] static uint32_t current_thread_id();
+
+ private:
+  Tracer() = default;
+
+  [[nodiscard]] static int64_t steady_now_ns();
+
+  std::atomic<bool> enabled_ = false;
+
+  // steady_clock time of 'enable()', read without the lock by every span
+  std::atomic<int64_t> epoch_ns_ = steady_now_ns();
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::string> metadata_;
+  std::vector<TraceEvent> ring_;
+  size_t next_ = 0;
+  bool wrapped_ = false;
+};
+
+// Records the lifetime of the enclosing scope as a host span
+class ScopedTrace {
+ public:
+  explicit ScopedTrace(const char* name) {
+    if (Tracer::instance().is_enabled()) {
+      name_ = name;
+      begin_ns_ = Tracer::instance().now_ns();
+    }
+  }
+
+  ~ScopedTrace() {
+    if (name_ && Tracer::instance().is_enabled()) {
+      Tracer::instance().record(TraceEvent{
+          .name = name_,
+          .begin_ns = begin_ns_,
+          .end_ns = Tracer::instance().now_ns(),
+          .thread_id = Tracer::current_thread_id(),
+      });
+    }
+  }
+
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+ private:
+  const char* name_ = nullptr;
+  uint64_t begin_ns_ = 0;
+};
+
+}  // namespace vulkan
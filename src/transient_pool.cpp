@@ -0,0 +1,159 @@
+#include "transient_pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace vulkan {
+
+namespace {
+
+constexpr vk::DeviceSize align_up(const vk::DeviceSize value, const vk::DeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+TransientPool::TransientPool(VulkanMemoryResource* mr_ptr, const vk::DeviceSize alignment)
+    : mr_ptr_(mr_ptr), alignment_(std::max<vk::DeviceSize>(alignment, 16)) {
+  spdlog::trace("TransientPool constructor");
+}
+
+TransientPool::~TransientPool() {
+  if (backing_) {
+    mr_ptr_->deallocate(backing_, capacity_, alignment_);
+  }
+}
+
+TransientPool::Handle TransientPool::declare(const vk::DeviceSize bytes,
+                                             const uint32_t first_use,
+                                             const uint32_t last_use) {
+  if (bytes == 0) {
+    throw std::runtime_error("Transient buffer size is 0");
+  }
+  if (first_use > last_use) {
+    throw std::runtime_error("Transient buffer is last used before its first use");
+  }
+
+  declarations_.push_back(Declaration{
+      .bytes = align_up(bytes, alignment_),
+      .first_use = first_use,
+      .last_use = last_use,
+  });
+
+  planned_ = false;
+  return declarations_.size() - 1;
+}
+
+void TransientPool::reset() {
+  declarations_.clear();
+  planned_ = false;
+}
+
+// ----------------------------------------------------------------------------
+// Planning
+// ----------------------------------------------------------------------------
+
+void TransientPool::plan() {
+  if (declarations_ == planned_declarations_) {
+    planned_ = true;
+    return;
+  }
+
+  spdlog::trace("TransientPool::plan() {} temporaries", declarations_.size());
+
+  // Greedy by size: place each temporary at the lowest offset that does not
+  // collide with an already placed one whose lifetime overlaps
+  std::vector<Handle> order(declarations_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::ranges::stable_sort(order, std::ranges::greater{}, [this](const Handle h) {
+    return declarations_[h].bytes;
+  });
+
+  offsets_.assign(declarations_.size(), 0);
+  planned_bytes_ = 0;
+
+  std::vector<Handle> placed;
+  std::vector<std::pair<vk::DeviceSize, vk::DeviceSize>> taken;  // [begin, end)
+
+  for (const auto h : order) {
+    const auto& d = declarations_[h];
+
+    taken.clear();
+    for (const auto p : placed) {
+      const auto& other = declarations_[p];
+      if (d.first_use <= other.last_use && other.first_use <= d.last_use) {
+        taken.emplace_back(offsets_[p], offsets_[p] + other.bytes);
+      }
+    }
+    std::ranges::sort(taken);
+
+    vk::DeviceSize offset = 0;
+    for (const auto& [begin, end] : taken) {
+      if (offset + d.bytes <= begin) {
+        break;
+      }
+      offset = std::max(offset, end);
+    }
+
+    offsets_[h] = offset;
+    planned_bytes_ = std::max(planned_bytes_, offset + d.bytes);
+    placed.push_back(h);
+  }
+
+  planned_declarations_ = declarations_;
+  planned_ = true;
+
+  reserve(planned_bytes_);
+
+  spdlog::debug("TransientPool: {} temporaries, {} bytes declared, {} bytes planned",
+                declarations_.size(),
+                get_declared_bytes(),
+                planned_bytes_);
+}
+
+void TransientPool::reserve(const vk::DeviceSize bytes) {
+  if (bytes <= capacity_) {
+    return;
+  }
+
+  // Grow geometrically so slowly growing inputs do not reallocate every iteration
+  const auto new_capacity = std::max(bytes, capacity_ + capacity_ / 2);
+
+  if (backing_) {
+    mr_ptr_->deallocate(backing_, capacity_, alignment_);
+  }
+
+  backing_ = mr_ptr_->allocate(new_capacity, alignment_);
+  capacity_ = new_capacity;
+  backing_slice_ = mr_ptr_->get_buffer_slice(backing_);
+}
+
+// ----------------------------------------------------------------------------
+// Access
+// ----------------------------------------------------------------------------
+
+vk::DeviceSize TransientPool::offset_of(const Handle handle) const {
+  if (!planned_) {
+    throw std::runtime_error("TransientPool::plan() was not called");
+  }
+  return offsets_.at(handle);
+}
+
+vk::DescriptorBufferInfo TransientPool::get_buffer_info(const Handle handle) const {
+  return vk::DescriptorBufferInfo{
+      .buffer = backing_slice_.buffer,
+      .offset = backing_slice_.offset + offset_of(handle),
+      .range = declarations_.at(handle).bytes,
+  };
+}
+
+vk::DeviceSize TransientPool::get_declared_bytes() const {
+  vk::DeviceSize total = 0;
+  for (const auto& d : declarations_) {
+    total += d.bytes;
+  }
+  return total;
+}
+
+}  // namespace vulkan
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+
+#include "vk.hpp"
+#include "vma_pmr.hpp"
+
+namespace vulkan {
+
+// ----------------------------------------------------------------------------
+// TransientPool
+// ----------------------------------------------------------------------------
+
+/**
+ * @brief Memory for short-lived temporaries of a multi-stage pipeline, aliased by lifetime
+ *
+ * Each temporary is declared with the range of steps (e.g. dispatch indices
+ * of a recording) it is used in. 'plan()' places temporaries whose lifetimes
+ * do not overlap at overlapping offsets of one backing allocation, so peak
+ * memory is the largest set of simultaneously live temporaries rather than
+ * their sum. The backing allocation only grows and is kept across
+ * iterations; re-declaring the same temporaries reuses the previous plan, so
+ * a steady-state loop makes no allocator calls at all.
+ *
+ * Aliased temporaries live in the same VkBuffer, so 'Sequence' places the
+ * barriers between a temporary's last reader and the next one's writer.
+ *
+ * Example usage:
+ * ```cpp
+ * auto pool = engine.make_transient_pool();
+ * for (auto& batch : batches) {
+ *   pool->reset();
+ *   const auto flags = pool->declare(n * sizeof(uint32_t), 0, 1);
+ *   const auto sums = pool->declare(n * sizeof(uint32_t), 1, 2);
+ *   const auto offsets = pool->declare(n * sizeof(uint32_t), 2, 3);  // may alias 'flags'
+ *   pool->plan();
+ *   algo->update_buffer({pool->get_buffer_info(flags), ...});
+ * }
+ * ```
+ */
+class TransientPool {
+ public:
+  using Handle = size_t;
+
+  // 'alignment' must be a multiple of minStorageBufferOffsetAlignment
+  explicit TransientPool(VulkanMemoryResource* mr_ptr, vk::DeviceSize alignment);
+
+  ~TransientPool();
+
+  TransientPool(const TransientPool&) = delete;
+  TransientPool& operator=(const TransientPool&) = delete;
+
+  /**
+   * @brief Declare a temporary used from step 'first_use' to 'last_use' (inclusive)
+   * @return Handle valid until the next 'reset()'
+   */
+  Handle declare(vk::DeviceSize bytes, uint32_t first_use, uint32_t last_use);
+
+  // Assign offsets to everything declared since 'reset()'. Growing the backing memory
+  // releases the old one, so no submission may still use the pool.
+  void plan();
+
+  // Forget the declarations, the backing memory is kept
+  void reset();
+
+  [[nodiscard]] vk::DescriptorBufferInfo get_buffer_info(Handle handle) const;
+
+  // Host pointer to a temporary (USM memory is mapped)
+  template <typename T>
+  [[nodiscard]] T* data(const Handle handle) const {
+    return reinterpret_cast<T*>(static_cast<std::byte*>(backing_) + offset_of(handle));
+  }
+
+  // Bytes the current plan needs, and the sum of all declared sizes for comparison
+  [[nodiscard]] vk::DeviceSize get_planned_bytes() const { return planned_bytes_; }
+  [[nodiscard]] vk::DeviceSize get_declared_bytes() const;
+
+  [[nodiscard]] vk::DeviceSize get_capacity() const { return capacity_; }
+
+ private:
+  struct Declaration {
+    vk::DeviceSize bytes;
+    uint32_t first_use;
+    uint32_t last_use;
+
+    bool operator==(const Declaration&) const = default;
+  };
+
+  [[nodiscard]] vk::DeviceSize offset_of(Handle handle) const;
+  void reserve(vk::DeviceSize bytes);
+
+  VulkanMemoryResource* mr_ptr_;
+  vk::DeviceSize alignment_;
+
+  std::vector<Declaration> declarations_;
+
+  // Result of the last 'plan()', reused while the declarations stay the same
+  std::vector<Declaration> planned_declarations_;
+  std::vector<vk::DeviceSize> offsets_;
+  vk::DeviceSize planned_bytes_ = 0;
+  bool planned_ = false;
+
+  void* backing_ = nullptr;
+  vk::DeviceSize capacity_ = 0;
+  BufferSlice backing_slice_;
+};
+
+}  // namespace vulkan
@@ -1,5 +1,10 @@
 #include "vma_pmr.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <span>
+
 namespace vulkan {
 
 void CHECK_VK_RESULT(VkResult result, const char *msg) {
@@ -9,6 +14,21 @@ void CHECK_VK_RESULT(VkResult result, const char *msg) {
   }
 }
 
+vk::BufferCreateInfo make_buffer_create_info(const vk::DeviceSize size,
+                                             const vk::BufferUsageFlags usage,
+                                             const std::vector<uint32_t> &queue_family_indices) {
+  const bool concurrent = queue_family_indices.size() > 1;
+
+  return vk::BufferCreateInfo{
+      .size = size,
+      .usage = usage,
+      .sharingMode = concurrent ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+      .queueFamilyIndexCount =
+          concurrent ? static_cast<uint32_t>(queue_family_indices.size()) : 0u,
+      .pQueueFamilyIndices = concurrent ? queue_family_indices.data() : nullptr,
+  };
+}
+
 VulkanMemoryResource::VulkanMemoryResource(const vk::Device device,
                                            const vk::BufferUsageFlags buffer_usage,
                                            const VmaMemoryUsage memory_usage,
@@ -25,17 +45,339 @@ VulkanMemoryResource::VulkanMemoryResource(const vk::Device device,
       static_cast<int>(allocationFlags_));
 }
 
-VulkanMemoryResource::~VulkanMemoryResource() { spdlog::debug("VulkanMemoryResource destroyed"); }
+VulkanMemoryResource::~VulkanMemoryResource() {
+  if (!arena_allocations_.empty()) {
+    spdlog::warn("VulkanMemoryResource destroyed with {} live arena allocations",
+                 arena_allocations_.size());
+  }
 
-vk::Buffer VulkanMemoryResource::get_buffer_from_pointer(void *p) {
-  std::lock_guard lock(mutex_);
-  const auto it = allocations_.find(p);
-  if (it == allocations_.end()) {
-    // Handle unknown pointer; possibly throw an exception or return a null handle
+  for (const auto &block : arena_blocks_) {
+    vmaClearVirtualBlock(block.virtual_block);
+    vmaDestroyVirtualBlock(block.virtual_block);
+    vmaDestroyBuffer(g_vma_allocator, block.record.buffer, block.record.allocation);
+  }
+
+  spdlog::debug("VulkanMemoryResource destroyed");
+}
+
+vk::Buffer VulkanMemoryResource::get_buffer_from_pointer(void *p) const {
+  return get_buffer_slice(p).buffer;
+}
+
+BufferSlice VulkanMemoryResource::get_buffer_slice(const void *p) const {
+  const auto address = reinterpret_cast<std::uintptr_t>(p);
+
+  IndexedRange range{};
+  bool found = false;
+
+  while (true) {
+    const auto seq = index_seq_.load(std::memory_order_acquire);
+    if (seq & 1) {
+      continue;
+    }
+
+    found = false;
+
+    // Arrays stay alive until destruction, so a torn read stays in bounds and is retried
+    if (const auto *array = index_array_.load(std::memory_order_acquire)) {
+      const std::span ranges(array->data.get(),
+                             std::min(index_size_.load(std::memory_order_relaxed),
+                                      array->capacity));
+
+      // Last range starting at or before 'address'
+      const auto it = std::ranges::upper_bound(ranges, address, {}, &IndexedRange::begin);
+      if (it != ranges.begin() && address < std::prev(it)->end) {
+        range = *std::prev(it);
+        found = true;
+      }
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (index_seq_.load(std::memory_order_relaxed) == seq) {
+      break;
+    }
+  }
+
+  if (!found) {
     throw std::runtime_error("Unknown pointer in get_buffer_from_pointer");
   }
-  // Construct a vk::Buffer handle from the stored VkBuffer
-  return {it->second.buffer};
+
+  return BufferSlice{
+      .buffer = range.buffer,
+      .offset = range.offset + (address - range.begin),
+      .size = range.end - address,
+      .device_address = range.device_address ? range.device_address + (address - range.begin) : 0,
+  };
+}
+
+void VulkanMemoryResource::index_write_begin_locked() {
+  index_seq_.store(index_seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void VulkanMemoryResource::index_write_end_locked() {
+  index_seq_.store(index_seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void VulkanMemoryResource::index_insert_locked(IndexedRange range) {
+  // Queried once here, so resolving an address is as cheap as resolving a buffer
+  if (range.device_address == 0 && has_device_addresses()) {
+    range.device_address =
+        device_.getBufferAddress(vk::BufferDeviceAddressInfo{.buffer = range.buffer}) +
+        range.offset;
+  }
+
+  const auto size = index_size_.load(std::memory_order_relaxed);
+  RangeArray *array = index_arrays_.empty() ? nullptr : index_arrays_.back().get();
+
+  // Same contents in a larger array, readers can switch to it at any time
+  if (!array || size == array->capacity) {
+    auto grown = std::make_unique<RangeArray>(std::max<size_t>(64, 2 * size));
+    if (array) {
+      std::copy_n(array->data.get(), size, grown->data.get());
+    }
+    array = index_arrays_.emplace_back(std::move(grown)).get();
+    index_array_.store(array, std::memory_order_release);
+  }
+
+  IndexedRange *data = array->data.get();
+  const auto it =
+      std::ranges::upper_bound(data, data + size, range.begin, {}, &IndexedRange::begin);
+
+  index_write_begin_locked();
+  std::copy_backward(it, data + size, data + size + 1);
+  *it = range;
+  index_size_.store(size + 1, std::memory_order_relaxed);
+  index_write_end_locked();
+}
+
+bool VulkanMemoryResource::index_overlaps_locked(const std::uintptr_t begin,
+                                                 const std::uintptr_t end) const {
+  if (index_arrays_.empty()) {
+    return false;
+  }
+
+  const IndexedRange *data = index_arrays_.back()->data.get();
+  const auto *last = data + index_size_.load(std::memory_order_relaxed);
+
+  // First range starting at or after 'end', the one before it is the only candidate
+  const auto it = std::ranges::lower_bound(data, last, end, {}, &IndexedRange::begin);
+  return it != data && std::prev(it)->end > begin;
+}
+
+void VulkanMemoryResource::index_erase_locked(const void *p) {
+  if (index_arrays_.empty()) {
+    return;
+  }
+
+  const auto size = index_size_.load(std::memory_order_relaxed);
+  IndexedRange *data = index_arrays_.back()->data.get();
+
+  const auto address = reinterpret_cast<std::uintptr_t>(p);
+  const auto it = std::ranges::lower_bound(data, data + size, address, {}, &IndexedRange::begin);
+  if (it == data + size || it->begin != address) {
+    return;
+  }
+
+  index_write_begin_locked();
+  std::copy(it + 1, data + size, it);
+  index_size_.store(size - 1, std::memory_order_relaxed);
+  index_write_end_locked();
+}
+
+void VulkanMemoryResource::set_queue_family_indices(std::vector<uint32_t> queue_family_indices) {
+  std::lock_guard lock(mutex_);
+  queue_family_indices_ = std::move(queue_family_indices);
+}
+
+MemoryStats VulkanMemoryResource::get_stats() const {
+  std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+void VulkanMemoryResource::set_soft_limit(const size_t max_live_bytes,
+                                          const bool within_heap_budget) {
+  std::lock_guard lock(mutex_);
+  soft_limit_ = max_live_bytes;
+  within_heap_budget_ = within_heap_budget;
+}
+
+void VulkanMemoryResource::enable_arena(const vk::DeviceSize block_size) {
+  if (block_size == 0) {
+    throw std::runtime_error("Arena block size is 0");
+  }
+
+  const VkPhysicalDeviceProperties *properties = nullptr;
+  vmaGetPhysicalDeviceProperties(g_vma_allocator, &properties);
+
+  std::lock_guard lock(mutex_);
+  arena_block_size_ = block_size;
+  arena_alignment_ = properties->limits.minStorageBufferOffsetAlignment;
+
+  spdlog::debug("VulkanMemoryResource arena enabled, block size = {}, alignment = {}",
+                arena_block_size_,
+                arena_alignment_);
+}
+
+// ----------------------------------------------------------------------------
+// Host memory import
+// ----------------------------------------------------------------------------
+
+void VulkanMemoryResource::enable_host_import(const vk::DeviceSize alignment) {
+  std::lock_guard lock(mutex_);
+  host_import_alignment_ = alignment;
+}
+
+BufferSlice VulkanMemoryResource::import_host_pointer(void *p, const std::size_t bytes) {
+  spdlog::trace("VulkanMemoryResource::import_host_pointer({}, {})", p, bytes);
+
+  std::lock_guard lock(mutex_);
+
+  if (!supports_host_import()) {
+    throw std::runtime_error("Host memory import is not supported");
+  }
+  if (imports_.contains(p)) {
+    throw std::runtime_error("Host pointer is already imported");
+  }
+
+  const auto address = reinterpret_cast<std::uintptr_t>(p);
+
+  // 'get_buffer_slice()' could not tell which buffer an address belongs to
+  if (index_overlaps_locked(address, address + bytes)) {
+    throw std::runtime_error("Host range overlaps an imported or allocated range");
+  }
+  const auto base = address / host_import_alignment_ * host_import_alignment_;
+  const auto end =
+      (address + bytes + host_import_alignment_ - 1) / host_import_alignment_ *
+      host_import_alignment_;
+  const auto base_ptr = reinterpret_cast<void *>(base);
+
+  constexpr auto handle_type = vk::ExternalMemoryHandleTypeFlagBits::eHostAllocationEXT;
+
+  const auto host_properties = device_.getMemoryHostPointerPropertiesEXT(handle_type, base_ptr);
+
+  const vk::ExternalMemoryBufferCreateInfo external_info{
+      .handleTypes = handle_type,
+  };
+
+  // Always addressable, so bindless kernels can read imported memory like USM vectors
+  auto buffer_create_info =
+      make_buffer_create_info(end - base,
+                              bufferUsage_ | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+                              queue_family_indices_);
+  buffer_create_info.pNext = &external_info;
+
+  const auto buffer = device_.createBuffer(buffer_create_info);
+  const auto requirements = device_.getBufferMemoryRequirements(buffer);
+
+  const auto type_bits = host_properties.memoryTypeBits & requirements.memoryTypeBits;
+  if (type_bits == 0) {
+    device_.destroyBuffer(buffer);
+    throw std::runtime_error("No memory type can import this host pointer");
+  }
+
+  // Prefer a coherent type, a non-coherent one is mapped so it can be flushed and invalidated
+  const VkPhysicalDeviceMemoryProperties *memory_properties = nullptr;
+  vmaGetMemoryProperties(g_vma_allocator, &memory_properties);
+
+  auto type_index = static_cast<uint32_t>(std::countr_zero(type_bits));
+  for (auto bits = type_bits; bits != 0; bits &= bits - 1) {
+    const auto i = static_cast<uint32_t>(std::countr_zero(bits));
+    if (memory_properties->memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+      type_index = i;
+      break;
+    }
+  }
+
+  const auto type_flags = memory_properties->memoryTypes[type_index].propertyFlags;
+  const bool non_coherent = (type_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) &&
+                            !(type_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+  const vk::ImportMemoryHostPointerInfoEXT import_info{
+      .handleType = handle_type,
+      .pHostPointer = base_ptr,
+  };
+
+  // VMA sets this for its own allocations, imported memory needs it explicitly
+  const vk::MemoryAllocateFlagsInfo flags_info{
+      .pNext = &import_info,
+      .flags = vk::MemoryAllocateFlagBits::eDeviceAddress,
+  };
+
+  const vk::MemoryAllocateInfo allocate_info{
+      .pNext = &flags_info,
+      .allocationSize = end - base,
+      .memoryTypeIndex = type_index,
+  };
+
+  vk::DeviceMemory memory;
+  try {
+    memory = device_.allocateMemory(allocate_info);
+    device_.bindBufferMemory(buffer, memory, 0);
+    if (non_coherent) {
+      (void)device_.mapMemory(memory, 0, VK_WHOLE_SIZE);
+    }
+  } catch (...) {
+    device_.freeMemory(memory);
+    device_.destroyBuffer(buffer);
+    throw;
+  }
+
+  imports_.emplace(p, ImportRecord{buffer, memory, non_coherent});
+
+  if (non_coherent) {
+    const VkPhysicalDeviceProperties *device_properties = nullptr;
+    vmaGetPhysicalDeviceProperties(g_vma_allocator, &device_properties);
+
+    non_coherent_imports_[buffer] = NonCoherentImport{
+        .memory = memory,
+        .size = end - base,
+        .atom_size = device_properties->limits.nonCoherentAtomSize,
+    };
+    non_coherent_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const auto device_address =
+      device_.getBufferAddress(vk::BufferDeviceAddressInfo{.buffer = buffer}) + (address - base);
+
+  index_insert_locked(IndexedRange{
+      .begin = address,
+      .end = address + bytes,
+      .buffer = buffer,
+      .offset = address - base,
+      .device_address = device_address,
+  });
+
+  spdlog::debug("VulkanMemoryResource: imported {} bytes of host memory (coherent: {})",
+                bytes,
+                !non_coherent);
+
+  return BufferSlice{
+      .buffer = buffer,
+      .offset = address - base,
+      .size = bytes,
+      .device_address = device_address,
+  };
+}
+
+void VulkanMemoryResource::release_host_pointer(void *p) {
+  std::lock_guard lock(mutex_);
+
+  const auto it = imports_.find(p);
+  if (it == imports_.end()) {
+    throw std::runtime_error("Unknown pointer in release_host_pointer");
+  }
+
+  if (it->second.mapped) {
+    device_.unmapMemory(it->second.memory);
+    non_coherent_imports_.erase(it->second.buffer);
+    non_coherent_count_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  device_.destroyBuffer(it->second.buffer);
+  device_.freeMemory(it->second.memory);
+  imports_.erase(it);
+  index_erase_locked(p);
 }
 
 // vk::DescriptorBufferInfo VulkanMemoryResource::make_descriptor_buffer_info(
@@ -49,16 +391,15 @@ vk::Buffer VulkanMemoryResource::get_buffer_from_pointer(void *p) {
 //       .buffer = buffer, .offset = 0, .range = mem_reqs.memoryRequirements.size};
 // }
 
-void *VulkanMemoryResource::do_allocate(std::size_t bytes, [[maybe_unused]] std::size_t alignment) {
-  spdlog::trace("VulkanMemoryResource::do_allocate({}, {})", bytes, alignment);
-
-  const vk::BufferCreateInfo buffer_create_info{
-      .size = bytes,
-      .usage = bufferUsage_,
-  };
+VulkanAllocationRecord VulkanMemoryResource::create_buffer(
+    const std::size_t bytes,
+    const std::vector<uint32_t> &queue_family_indices,
+    const VmaAllocationCreateFlags flags) const {
+  const auto buffer_create_info =
+      make_buffer_create_info(bytes, bufferUsage_, queue_family_indices);
 
   VmaAllocationCreateInfo allocCreateInfo{};
-  allocCreateInfo.flags = allocationFlags_;
+  allocCreateInfo.flags = flags;
   allocCreateInfo.usage = memoryUsage_;
 
   VkBuffer buffer;
@@ -76,31 +417,263 @@ void *VulkanMemoryResource::do_allocate(std::size_t bytes, [[maybe_unused]] std:
 
   // The memory should already be mapped due to the
   // VMA_ALLOCATION_CREATE_MAPPED_BIT flag.
-  void *mappedPtr = allocInfo.pMappedData;
-  if (!mappedPtr) {
+  if (!allocInfo.pMappedData) {
     // If it's not mapped for some reason, we can attempt to map it.
     // According to the flags, it should be mapped already, but just in case:
-    res = vmaMapMemory(g_vma_allocator, allocation, &mappedPtr);
+    res = vmaMapMemory(g_vma_allocator, allocation, &allocInfo.pMappedData);
     CHECK_VK_RESULT(res, "Failed to map VMA buffer memory");
   }
 
+  return VulkanAllocationRecord{buffer, allocation, allocInfo};
+}
+
+void *VulkanMemoryResource::arena_allocate_locked(const std::size_t bytes,
+                                                  const std::size_t alignment) {
+  const VmaVirtualAllocationCreateInfo create_info{
+      .size = bytes,
+      .alignment = std::max<vk::DeviceSize>(alignment, arena_alignment_),
+  };
+
+  const auto try_block = [&](const size_t block_index) -> void * {
+    VmaVirtualAllocation allocation;
+    VkDeviceSize offset;
+
+    if (vmaVirtualAllocate(
+            arena_blocks_[block_index].virtual_block, &create_info, &allocation, &offset) !=
+        VK_SUCCESS) {
+      return nullptr;
+    }
+
+    void *p = arena_blocks_[block_index].mapped + offset;
+    arena_allocations_[p] = ArenaAllocation{block_index, allocation, offset, bytes};
+
+    const auto address = reinterpret_cast<std::uintptr_t>(p);
+    index_insert_locked(IndexedRange{
+        .begin = address,
+        .end = address + bytes,
+        .buffer = arena_blocks_[block_index].record.buffer,
+        .offset = offset,
+        .device_address = 0,
+    });
+    return p;
+  };
+
+  for (size_t i = 0; i < arena_blocks_.size(); ++i) {
+    if (void *p = try_block(i)) {
+      return p;
+    }
+  }
+
+  // All blocks are full (or fragmented), add one
+  ArenaBlock block{
+      .record = create_buffer(arena_block_size_, queue_family_indices_, allocation_flags_locked()),
+      .mapped = nullptr,
+      .virtual_block = VK_NULL_HANDLE,
+  };
+  block.mapped = static_cast<std::byte *>(block.record.allocInfo.pMappedData);
+
+  const VmaVirtualBlockCreateInfo block_create_info{
+      .size = arena_block_size_,
+  };
+  const VkResult res = vmaCreateVirtualBlock(&block_create_info, &block.virtual_block);
+  if (res != VK_SUCCESS) {
+    vmaDestroyBuffer(g_vma_allocator, block.record.buffer, block.record.allocation);
+  }
+  CHECK_VK_RESULT(res, "Failed to create arena block");
+
+  arena_blocks_.push_back(block);
+  track_coherency_locked(block.record);
+  spdlog::debug("VulkanMemoryResource: arena block #{} created", arena_blocks_.size());
+
+  return try_block(arena_blocks_.size() - 1);
+}
+
+void *VulkanMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  spdlog::trace("VulkanMemoryResource::do_allocate({}, {})", bytes, alignment);
+
+  std::vector<uint32_t> queue_family_indices;
+  VmaAllocationCreateFlags flags;
+  {
+    std::lock_guard lock(mutex_);
+
+    if (soft_limit_ > 0 && stats_.live_bytes + bytes > soft_limit_) {
+      ++stats_.rejected_allocations;
+      spdlog::warn("VulkanMemoryResource: {} bytes rejected, {} of {} bytes live",
+                   bytes,
+                   stats_.live_bytes,
+                   soft_limit_);
+      throw std::bad_alloc();
+    }
+
+    // Counted once the allocation succeeded, adding a block may throw
+    if (arena_block_size_ > 0 && bytes <= arena_block_size_ / 4) {
+      if (void *p = arena_allocate_locked(bytes, alignment)) {
+        record_allocation_locked(bytes);
+        return p;
+      }
+    }
+
+    // Reserved now so concurrent allocations see it against the soft limit, rolled back below
+    record_allocation_locked(bytes);
+
+    queue_family_indices = queue_family_indices_;
+    flags = allocation_flags_locked();
+  }
+
+  VulkanAllocationRecord record;
+  try {
+    record = create_buffer(bytes, queue_family_indices, flags);
+  } catch (...) {
+    std::lock_guard lock(mutex_);
+    record_deallocation_locked(bytes);
+    ++stats_.rejected_allocations;
+    throw;
+  }
+
+  void *mappedPtr = record.allocInfo.pMappedData;
+
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    allocations_[mappedPtr] = VulkanAllocationRecord{buffer, allocation, allocInfo};
+    allocations_[mappedPtr] = record;
+    track_coherency_locked(record);
+
+    const auto address = reinterpret_cast<std::uintptr_t>(mappedPtr);
+    index_insert_locked(IndexedRange{
+        .begin = address,
+        .end = address + bytes,
+        .buffer = record.buffer,
+        .offset = 0,
+        .device_address = 0,
+    });
   }
 
   return mappedPtr;
 }
 
+void VulkanMemoryResource::record_allocation_locked(const size_t bytes) {
+  stats_.live_bytes += bytes;
+  stats_.peak_bytes = std::max(stats_.peak_bytes, stats_.live_bytes);
+  ++stats_.live_allocations;
+  ++stats_.total_allocations;
+
+  const auto bucket = std::min<size_t>(std::bit_width(bytes | 1) - 1,
+                                       stats_.size_histogram.size() - 1);
+  ++stats_.size_histogram[bucket];
+}
+
+void VulkanMemoryResource::record_deallocation_locked(const size_t bytes) {
+  stats_.live_bytes -= std::min(bytes, stats_.live_bytes);
+  --stats_.live_allocations;
+}
+
+VmaAllocationCreateFlags VulkanMemoryResource::allocation_flags_locked() const {
+  auto flags = allocationFlags_;
+  if (within_heap_budget_) {
+    flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+  }
+  return flags;
+}
+
+// ----------------------------------------------------------------------------
+// Coherency
+// ----------------------------------------------------------------------------
+
+void VulkanMemoryResource::track_coherency_locked(const VulkanAllocationRecord &record) {
+  VkMemoryPropertyFlags memory_flags = 0;
+  vmaGetAllocationMemoryProperties(g_vma_allocator, record.allocation, &memory_flags);
+
+  if (!(memory_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+    non_coherent_[record.buffer] = record.allocation;
+    non_coherent_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void VulkanMemoryResource::set_prefer_host_cached(const bool cached) {
+  std::lock_guard lock(mutex_);
+
+  allocationFlags_ &= ~(VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
+                        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+  allocationFlags_ |= cached ? VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT
+                             : VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+}
+
+void VulkanMemoryResource::flush_range(const vk::Buffer buffer,
+                                       const vk::DeviceSize offset,
+                                       const vk::DeviceSize size) {
+  if (!has_non_coherent_memory()) {
+    return;
+  }
+
+  std::lock_guard lock(mutex_);
+  if (const auto it = non_coherent_.find(buffer); it != non_coherent_.end()) {
+    CHECK_VK_RESULT(vmaFlushAllocation(g_vma_allocator, it->second, offset, size),
+                    "Failed to flush allocation");
+  } else if (const auto import = non_coherent_imports_.find(buffer);
+             import != non_coherent_imports_.end()) {
+    device_.flushMappedMemoryRanges(import->second.atom_range(offset, size));
+  }
+}
+
+void VulkanMemoryResource::invalidate_range(const vk::Buffer buffer,
+                                            const vk::DeviceSize offset,
+                                            const vk::DeviceSize size) {
+  if (!has_non_coherent_memory()) {
+    return;
+  }
+
+  std::lock_guard lock(mutex_);
+  if (const auto it = non_coherent_.find(buffer); it != non_coherent_.end()) {
+    CHECK_VK_RESULT(vmaInvalidateAllocation(g_vma_allocator, it->second, offset, size),
+                    "Failed to invalidate allocation");
+  } else if (const auto import = non_coherent_imports_.find(buffer);
+             import != non_coherent_imports_.end()) {
+    device_.invalidateMappedMemoryRanges(import->second.atom_range(offset, size));
+  }
+}
+
+vk::MappedMemoryRange VulkanMemoryResource::NonCoherentImport::atom_range(
+    const vk::DeviceSize offset, const vk::DeviceSize bytes) const {
+  const auto begin = offset / atom_size * atom_size;
+  const auto end = bytes == VK_WHOLE_SIZE
+                       ? size
+                       : std::min(size, (offset + bytes + atom_size - 1) / atom_size * atom_size);
+
+  return vk::MappedMemoryRange{
+      .memory = memory,
+      .offset = begin,
+      .size = end == size ? VK_WHOLE_SIZE : end - begin,
+  };
+}
+
+void VulkanMemoryResource::flush(const void *p, const std::size_t bytes) {
+  const auto slice = get_buffer_slice(p);
+  flush_range(slice.buffer, slice.offset, bytes);
+}
+
+void VulkanMemoryResource::invalidate(const void *p, const std::size_t bytes) {
+  const auto slice = get_buffer_slice(p);
+  invalidate_range(slice.buffer, slice.offset, bytes);
+}
+
 // Deallocate the buffer by looking up our record.
 void VulkanMemoryResource::do_deallocate(void *p,
-                                         [[maybe_unused]] std::size_t bytes,
+                                         std::size_t bytes,
                                          [[maybe_unused]] std::size_t alignment) {
   spdlog::trace("VulkanMemoryResource::do_deallocate({}, {}, {})", p, bytes, alignment);
 
   VulkanAllocationRecord record;
   {
     std::lock_guard lock(mutex_);
+
+    // Arena allocations only give their range back to the block
+    if (const auto it = arena_allocations_.find(p); it != arena_allocations_.end()) {
+      record_deallocation_locked(bytes);
+      vmaVirtualFree(arena_blocks_[it->second.block_index].virtual_block, it->second.allocation);
+      arena_allocations_.erase(it);
+      index_erase_locked(p);
+      return;
+    }
+
     const auto it = allocations_.find(p);
     if (it == allocations_.end()) {
       spdlog::error(
@@ -108,8 +681,13 @@ void VulkanMemoryResource::do_deallocate(void *p,
           "VulkanMemoryResource");
       throw std::runtime_error("Unknown pointer in VulkanMemoryResource::do_deallocate");
     }
+    record_deallocation_locked(bytes);
     record = it->second;
     allocations_.erase(it);
+    if (non_coherent_.erase(record.buffer) > 0) {
+      non_coherent_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    index_erase_locked(p);
   }
 
   // Destroy the buffer and free the allocation
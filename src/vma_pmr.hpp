@@ -6,10 +6,15 @@
 #include <vk_mem_alloc.h>
 
 // Standard Library
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <memory_resource>
 #include <mutex>
 // #include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
 #include "vk.hpp"
 
@@ -17,6 +22,40 @@ extern VmaAllocator g_vma_allocator;
 
 namespace vulkan {
 
+// A (buffer, offset, size) range backing a USM pointer
+struct BufferSlice {
+  vk::Buffer buffer;
+  vk::DeviceSize offset = 0;
+  vk::DeviceSize size = 0;
+
+  // GPU address of 'offset', 0 unless buffers have 'eShaderDeviceAddress' usage
+  vk::DeviceAddress device_address = 0;
+};
+
+// Allocation statistics of one 'VulkanMemoryResource' (requested sizes)
+struct MemoryStats {
+  size_t live_bytes = 0;
+  size_t peak_bytes = 0;
+  size_t live_allocations = 0;
+  size_t total_allocations = 0;
+  size_t rejected_allocations = 0;
+
+  // Allocations by size, bucket i counts sizes in [2^i, 2^(i+1))
+  std::array<size_t, 48> size_histogram{};
+};
+
+/**
+ * @brief Create info of a buffer used by the queues of 'queue_family_indices'
+ *
+ * Sharing is concurrent when several families use the buffer, so no ownership
+ * transfers are needed, and exclusive otherwise. The returned struct points
+ * into 'queue_family_indices', which must outlive it.
+ */
+[[nodiscard]] vk::BufferCreateInfo make_buffer_create_info(
+    vk::DeviceSize size,
+    vk::BufferUsageFlags usage,
+    const std::vector<uint32_t>& queue_family_indices);
+
 // Structure to keep track of the buffer allocation details
 struct VulkanAllocationRecord {
   VkBuffer buffer;
@@ -42,7 +81,90 @@ class VulkanMemoryResource : public std::pmr::memory_resource {
 
   [[nodiscard]] vk::Device get_device() const { return device_; }
 
-  [[nodiscard]] vk::Buffer get_buffer_from_pointer(void *p);
+  [[nodiscard]] vk::Buffer get_buffer_from_pointer(void *p) const;
+
+  /**
+   * @brief Resolve any pointer into a live allocation to its buffer range
+   * @param p Base or interior pointer, e.g. 'vec.data() + k'
+   * @return Buffer, offset of 'p' in it and bytes from 'p' to the end of the allocation
+   *
+   * Lock-free: reads the address index under a seqlock and retries if an
+   * allocation or deallocation edited it meanwhile.
+   */
+  [[nodiscard]] BufferSlice get_buffer_slice(const void *p) const;
+
+  [[nodiscard]] bool has_device_addresses() const {
+    return static_cast<bool>(bufferUsage_ & vk::BufferUsageFlagBits::eShaderDeviceAddress);
+  }
+
+  [[nodiscard]] MemoryStats get_stats() const;
+
+  // Coherency
+  //
+  // VMA may place allocations in cached, non-coherent memory. Host writes to
+  // such memory must be flushed before the GPU reads them, and GPU writes
+  // invalidated before the host reads them. 'Sequence' does both for the
+  // buffers it binds; these are for manual use. All are no-ops on coherent memory.
+  [[nodiscard]] bool has_non_coherent_memory() const {
+    return non_coherent_count_.load(std::memory_order_relaxed) > 0;
+  }
+
+  void flush(const void *p, std::size_t bytes);
+  void invalidate(const void *p, std::size_t bytes);
+  void flush_range(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size);
+  void invalidate_range(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize size);
+
+  // Cached memory (fast host reads, default) or write-combined memory (fast host writes)
+  // for allocations made afterwards
+  void set_prefer_host_cached(bool cached);
+
+  /**
+   * @brief Reject allocations before the driver runs out of memory
+   * @param max_live_bytes Allocations that would exceed this many live bytes throw
+   *                       'std::bad_alloc', 0 disables the limit
+   * @param within_heap_budget Also fail allocations that would exceed the heap budget
+   *                           (VK_EXT_memory_budget), instead of letting the driver page
+   */
+  void set_soft_limit(size_t max_live_bytes, bool within_heap_budget = true);
+
+  // Allow 'import_host_pointer()', 'alignment' is minImportedHostPointerAlignment
+  void enable_host_import(vk::DeviceSize alignment);
+
+  [[nodiscard]] bool supports_host_import() const { return host_import_alignment_ > 0; }
+
+  /**
+   * @brief Wrap memory the engine does not own in a VkBuffer (VK_EXT_external_memory_host)
+   * @param p Start of the range, e.g. an mmapped file
+   * @param bytes Size of the range
+   * @return The buffer range of 'p' with its device address, also registered for
+   *         'get_buffer_slice()'
+   *
+   * The range is widened to the import alignment, so the pages around it must
+   * be part of the same host allocation. A coherent memory type is preferred;
+   * otherwise the import is flushed and invalidated like other non-coherent
+   * memory. Throws if import is not supported, the
+   * driver refuses the pointer, or the range overlaps one that is already
+   * imported or allocated. The memory must stay valid until
+   * 'release_host_pointer()'.
+   */
+  BufferSlice import_host_pointer(void *p, std::size_t bytes);
+  void release_host_pointer(void *p);
+
+  /**
+   * @brief Sub-allocate small allocations from large shared buffers
+   * @param block_size Size of each arena buffer in bytes
+   *
+   * Allocations up to a quarter of 'block_size' are carved out of arena
+   * blocks (VMA virtual blocks), larger ones keep a dedicated buffer. Offsets
+   * are aligned to 'minStorageBufferOffsetAlignment', so any allocation can
+   * be bound with the offset from 'get_buffer_slice()'. Blocks are kept until
+   * the resource is destroyed.
+   */
+  void enable_arena(vk::DeviceSize block_size = 64ull << 20);
+
+  // Buffers allocated afterwards can be used from all these queue families without
+  // ownership transfers (concurrent sharing), has no effect for a single family
+  void set_queue_family_indices(std::vector<uint32_t> queue_family_indices);
 
   //   [[nodiscard]] vk::DescriptorBufferInfo make_descriptor_buffer_info(vk::Buffer buffer) const;
 
@@ -58,9 +180,110 @@ class VulkanMemoryResource : public std::pmr::memory_resource {
   vk::BufferUsageFlags bufferUsage_;
   VmaMemoryUsage memoryUsage_;
   VmaAllocationCreateFlags allocationFlags_;
+  std::vector<uint32_t> queue_family_indices_;
+
+  struct ArenaBlock {
+    VulkanAllocationRecord record;
+    std::byte *mapped;
+    VmaVirtualBlock virtual_block;
+  };
+
+  struct ArenaAllocation {
+    size_t block_index;
+    VmaVirtualAllocation allocation;
+    vk::DeviceSize offset;
+    vk::DeviceSize size;
+  };
+
+  // One live allocation in the address index
+  struct IndexedRange {
+    std::uintptr_t begin;
+    std::uintptr_t end;
+    vk::Buffer buffer;
+    vk::DeviceSize offset;
+    vk::DeviceAddress device_address;  // of 'begin', 0 without device address usage
+  };
+
+  // Storage of the address index, sorted by 'begin', ranges never overlap
+  struct RangeArray {
+    explicit RangeArray(const size_t capacity)
+        : capacity(capacity), data(std::make_unique<IndexedRange[]>(capacity)) {}
+
+    size_t capacity;
+    std::unique_ptr<IndexedRange[]> data;
+  };
+
+  // In-place updates of the address index, 'mutex_' must be held. Insert fills in the
+  // device address of the range.
+  void index_insert_locked(IndexedRange range);
+  void index_erase_locked(const void *p);
+  [[nodiscard]] bool index_overlaps_locked(std::uintptr_t begin, std::uintptr_t end) const;
+
+  // Brackets an edit, readers that overlap it retry
+  void index_write_begin_locked();
+  void index_write_end_locked();
+
+  [[nodiscard]] VulkanAllocationRecord create_buffer(
+      std::size_t bytes,
+      const std::vector<uint32_t> &queue_family_indices,
+      VmaAllocationCreateFlags flags) const;
+
+  // 'mutex_' must be held
+  [[nodiscard]] VmaAllocationCreateFlags allocation_flags_locked() const;
+  void track_coherency_locked(const VulkanAllocationRecord &record);
+  void record_allocation_locked(std::size_t bytes);
+  void record_deallocation_locked(std::size_t bytes);
+  void *arena_allocate_locked(std::size_t bytes, std::size_t alignment);
 
   mutable std::mutex mutex_;
   std::unordered_map<void *, VulkanAllocationRecord> allocations_;
+
+  // Address index, read without 'mutex_' under a seqlock: 'index_seq_' is odd while
+  // an edit is in progress. Arrays grow geometrically and superseded ones are kept
+  // until destruction (in total smaller than the current one), since a reader may
+  // still be searching them.
+  std::atomic<size_t> index_seq_ = 0;
+  std::atomic<const RangeArray *> index_array_ = nullptr;
+  std::atomic<size_t> index_size_ = 0;
+  std::vector<std::unique_ptr<RangeArray>> index_arrays_;
+
+  // Imported host memory, by the pointer given to 'import_host_pointer()'
+  struct ImportRecord {
+    vk::Buffer buffer;
+    vk::DeviceMemory memory;
+    bool mapped;  // non-coherent, see 'non_coherent_imports_'
+  };
+
+  vk::DeviceSize host_import_alignment_ = 0;
+  std::unordered_map<void *, ImportRecord> imports_;
+
+  // Buffers in non-coherent memory, which need explicit flush/invalidate
+  std::unordered_map<VkBuffer, VmaAllocation> non_coherent_;
+  std::atomic<size_t> non_coherent_count_ = 0;  // also counts the imports below
+
+  // Imported host memory in a non-coherent type, kept mapped for flush/invalidate
+  struct NonCoherentImport {
+    vk::DeviceMemory memory;
+    vk::DeviceSize size;
+    vk::DeviceSize atom_size;  // 'nonCoherentAtomSize'
+
+    // '[offset, offset + bytes)' widened to whole atoms, as the flush/invalidate calls require
+    [[nodiscard]] vk::MappedMemoryRange atom_range(vk::DeviceSize offset,
+                                                   vk::DeviceSize bytes) const;
+  };
+
+  std::unordered_map<VkBuffer, NonCoherentImport> non_coherent_imports_;
+
+  // Statistics and limits
+  MemoryStats stats_;
+  size_t soft_limit_ = 0;
+  bool within_heap_budget_ = false;
+
+  // Arena, disabled while 'arena_block_size_' is 0
+  vk::DeviceSize arena_block_size_ = 0;
+  vk::DeviceSize arena_alignment_ = 1;
+  std::vector<ArenaBlock> arena_blocks_;
+  std::unordered_map<void *, ArenaAllocation> arena_allocations_;
 };
 
 }  // namespace vulkan
\ No newline at end of file